@@ -42,6 +42,66 @@ namespace lsp
             static constexpr float CONV_LENGTH_DFL          = 0.0f;     // Convolution length (ms)
             static constexpr float CONV_LENGTH_STEP         = 0.1f;     // Convolution step (ms)
 
+            static constexpr float TRIM_LEVEL_MIN           = -120.0f;  // Minimum level of automatic tail trimming (dB)
+            static constexpr float TRIM_LEVEL_MAX           = -20.0f;   // Maximum level of automatic tail trimming (dB)
+            static constexpr float TRIM_LEVEL_DFL           = -60.0f;   // Level of automatic tail trimming (dB)
+            static constexpr float TRIM_LEVEL_STEP          = 0.1f;     // Level step of automatic tail trimming (dB)
+
+            static constexpr float CACHE_HITS_MIN           = 0.0f;     // Minimum hit rate of the resample cache (%)
+            static constexpr float CACHE_HITS_MAX           = 100.0f;   // Maximum hit rate of the resample cache (%)
+            static constexpr float CACHE_HITS_DFL           = 0.0f;     // Hit rate of the resample cache (%)
+            static constexpr float CACHE_HITS_STEP          = 0.1f;     // Hit rate step of the resample cache (%)
+
+            static constexpr float TAIL_SPLIT_MIN           = 20.0f;    // Minimum crossover point of the multi-rate tail (ms)
+            static constexpr float TAIL_SPLIT_MAX           = 2000.0f;  // Maximum crossover point of the multi-rate tail (ms)
+            static constexpr float TAIL_SPLIT_DFL           = 200.0f;   // Crossover point of the multi-rate tail (ms)
+            static constexpr float TAIL_SPLIT_STEP          = 0.1f;     // Crossover point step of the multi-rate tail (ms)
+
+            static constexpr float TAIL_SAVING_MIN          = 0.0f;     // Minimum CPU saving of the multi-rate tail (%)
+            static constexpr float TAIL_SAVING_MAX          = 100.0f;   // Maximum CPU saving of the multi-rate tail (%)
+            static constexpr float TAIL_SAVING_DFL          = 0.0f;     // CPU saving of the multi-rate tail (%)
+            static constexpr float TAIL_SAVING_STEP         = 0.1f;     // CPU saving step of the multi-rate tail (%)
+
+            static constexpr float HYBRID_SPLIT_MIN         = 50.0f;    // Minimum crossover point of the synthesized tail (ms)
+            static constexpr float HYBRID_SPLIT_MAX         = 2000.0f;  // Maximum crossover point of the synthesized tail (ms)
+            static constexpr float HYBRID_SPLIT_DFL         = 300.0f;   // Crossover point of the synthesized tail (ms)
+            static constexpr float HYBRID_SPLIT_STEP        = 0.1f;     // Crossover point step of the synthesized tail (ms)
+
+            static constexpr float HYBRID_ERROR_MIN         = 0.0f;     // Minimum spectral error of the synthesized tail (dB)
+            static constexpr float HYBRID_ERROR_MAX         = 48.0f;    // Maximum spectral error of the synthesized tail (dB)
+            static constexpr float HYBRID_ERROR_DFL         = 0.0f;     // Spectral error of the synthesized tail (dB)
+            static constexpr float HYBRID_ERROR_STEP        = 0.01f;    // Spectral error step of the synthesized tail (dB)
+
+            static constexpr float XFADE_MIN                = 0.0f;     // Minimum crossfade time between impulse responses (ms)
+            static constexpr float XFADE_MAX                = 1000.0f;  // Maximum crossfade time between impulse responses (ms)
+            static constexpr float XFADE_DFL                = 100.0f;   // Crossfade time between impulse responses (ms)
+            static constexpr float XFADE_STEP               = 0.1f;     // Crossfade time step between impulse responses (ms)
+
+            static constexpr float SWAP_LOAD_MIN            = 0.0f;     // Minimum temporary load of the impulse response swap (%)
+            static constexpr float SWAP_LOAD_MAX            = 200.0f;   // Maximum temporary load of the impulse response swap (%)
+            static constexpr float SWAP_LOAD_DFL            = 0.0f;     // Temporary load of the impulse response swap (%)
+            static constexpr float SWAP_LOAD_STEP           = 0.1f;     // Temporary load step of the impulse response swap (%)
+
+            static constexpr float JOBS_MIN                 = 0.0f;     // Minimum number of reconfiguration jobs
+            static constexpr float JOBS_MAX                 = 1e+7f;    // Maximum number of reconfiguration jobs
+            static constexpr float JOBS_DFL                 = 0.0f;     // Number of reconfiguration jobs
+            static constexpr float JOBS_STEP                = 1.0f;     // Step of the number of reconfiguration jobs
+
+            static constexpr float MORPH_MIN                = 0.0f;     // Minimum morph between impulse files (%)
+            static constexpr float MORPH_MAX                = 100.0f;   // Maximum morph between impulse files (%)
+            static constexpr float MORPH_DFL                = 0.0f;     // Morph between impulse files (%)
+            static constexpr float MORPH_STEP               = 0.1f;     // Morph step between impulse files (%)
+
+            static constexpr float BANK_USAGE_MIN           = 0.0f;     // Minimum memory usage of the bank (%)
+            static constexpr float BANK_USAGE_MAX           = 100.0f;   // Maximum memory usage of the bank (%)
+            static constexpr float BANK_USAGE_DFL           = 0.0f;     // Memory usage of the bank (%)
+            static constexpr float BANK_USAGE_STEP          = 0.1f;     // Memory usage step of the bank (%)
+
+            static constexpr float SHARED_MEMORY_MIN        = 0.0f;     // Minimum memory occupied by shared impulse responses (MB)
+            static constexpr float SHARED_MEMORY_MAX        = 65536.0f; // Maximum memory occupied by shared impulse responses (MB)
+            static constexpr float SHARED_MEMORY_DFL        = 0.0f;     // Memory occupied by shared impulse responses (MB)
+            static constexpr float SHARED_MEMORY_STEP       = 0.1f;     // Memory step of shared impulse responses (MB)
+
             static constexpr float PREDELAY_MIN             = 0.0f;     // Minimum pre-delay length (ms)
             static constexpr float PREDELAY_MAX             = 100.0f;   // Maximum pre-delay length (ms)
             static constexpr float PREDELAY_DFL             = 0.0f;     // Pre-delay length (ms)
@@ -66,7 +126,9 @@ namespace lsp
 
             static constexpr size_t MESH_SIZE               = 600;      // Maximum mesh size
             static constexpr size_t TRACKS_MAX              = 2;        // Maximum tracks per mesh/sample
+            static constexpr size_t TRUE_STEREO_TRACKS      = 4;        // Number of tracks of the true stereo impulse response
             static constexpr size_t FILES_MAX               = 2;        // Maximum number of files
+            static constexpr size_t BANK_SLOTS              = 8;        // Number of slots in the bank
 
             static constexpr size_t FFT_RANK_MIN            = 9;        // Minimum FFT rank
 
@@ -83,10 +145,49 @@ namespace lsp
 
                 FFT_RANK_DEFAULT = FFT_RANK_32767
             };
+
+            static constexpr size_t LATENCY_MIN             = 64;       // Minimum non-zero latency budget (samples)
+            static constexpr size_t LATENCY_MAX             = 8192;     // Maximum latency budget (samples)
+
+            enum latency_t
+            {
+                LATENCY_0,
+                LATENCY_64,
+                LATENCY_128,
+                LATENCY_256,
+                LATENCY_512,
+                LATENCY_1024,
+                LATENCY_2048,
+                LATENCY_4096,
+                LATENCY_8192,
+
+                LATENCY_DEFAULT = LATENCY_0
+            };
+
+            enum bank_limit_t
+            {
+                BANK_LIMIT_64M,
+                BANK_LIMIT_128M,
+                BANK_LIMIT_256M,
+                BANK_LIMIT_512M,
+                BANK_LIMIT_1G,
+                BANK_LIMIT_2G,
+
+                BANK_LIMIT_DEFAULT = BANK_LIMIT_512M
+            };
+
+            enum tail_factor_t
+            {
+                TAIL_FACTOR_2,
+                TAIL_FACTOR_4,
+
+                TAIL_FACTOR_DEFAULT = TAIL_FACTOR_2
+            };
         };
 
         extern const meta::plugin_t impulse_responses_mono;
         extern const meta::plugin_t impulse_responses_stereo;
+        extern const meta::plugin_t impulse_responses_mono_stereo;
     } // namespace meta
 } // namespace lsp
 
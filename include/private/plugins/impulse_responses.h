@@ -28,10 +28,17 @@
 #include <lsp-plug.in/dsp-units/filters/Equalizer.h>
 #include <lsp-plug.in/dsp-units/sampling/Sample.h>
 #include <lsp-plug.in/dsp-units/sampling/SamplePlayer.h>
-#include <lsp-plug.in/dsp-units/util/Convolver.h>
 #include <lsp-plug.in/dsp-units/util/Delay.h>
+#include <lsp-plug.in/io/Path.h>
 
 #include <private/meta/impulse_responses.h>
+#include <private/plugins/ir_arena.h>
+#include <private/plugins/ir_convolver.h>
+#include <private/plugins/ir_decay.h>
+#include <private/plugins/ir_disk_cache.h>
+#include <private/plugins/ir_pool.h>
+#include <private/plugins/ir_registry.h>
+#include <private/plugins/ir_worker.h>
 
 namespace lsp
 {
@@ -45,25 +52,70 @@ namespace lsp
             protected:
                 class IRLoader;
 
+                enum resample_cache_t
+                {
+                    RS_CACHE_SIZE   = 4             // Number of cached resampled copies per file
+                };
+
+                enum kernel_cache_t
+                {
+                    KC_QUEUE_SIZE   = IRConvolver::CHANNELS_MAX * IRConvolver::CHANNELS_MAX * 2    // Number of kernels waiting to be stored to the disk cache
+                };
+
+                typedef struct rs_cache_t
+                {
+                    dspu::Sample       *pSample;        // Resampled copy of the original sample, shared with other instances
+                    size_t              nSampleRate;    // Sample rate of the copy
+                    size_t              nBytes;         // Memory occupied by the copy
+                    size_t              nAccess;        // Last access time, used for eviction
+                } rs_cache_t;
+
+                typedef struct render_params_t
+                {
+                    float               fPitch;         // Pitch amount
+                    float               fHeadCut;       // Head cut (ms)
+                    float               fTailCut;       // Tail cut (ms)
+                    float               fFadeIn;        // Fade in (ms)
+                    float               fFadeOut;       // Fade out (ms)
+                    float               fTrimLevel;     // Level of the energy decay curve to trim the tail (dB)
+                    bool                bReverse;       // Reverse impulse response
+                    bool                bAutoTrim;      // Automatically trim the tail by the energy decay curve
+                } render_params_t;
+
                 typedef struct af_descriptor_t
                 {
                     dspu::Toggle        sListen;        // Listen toggle
                     dspu::Toggle        sStop;          // Stop toggle
-                    dspu::Sample       *pOriginal;      // Original file sample
+                    dspu::Sample       *pOriginal;      // Original file sample, shared with other instances
                     dspu::Sample       *pProcessed;     // Processed file sample by the reconfigure() call
+                    dspu::Sample       *pActive;        // Processed file sample currently bound to the sample player
+                    dspu::Sample       *pCached;        // Processed file sample loaded from the disk cache
                     float              *vThumbs[meta::impulse_responses_metadata::TRACKS_MAX];           // Thumbnails
+                    rs_cache_t          vCache[RS_CACHE_SIZE];  // Cache of resampled copies of the original sample
+                    IRDiskCache::key_t  sCacheKey;      // Disk cache key of the sample loaded from the disk cache
+                    io::Path            sPath;          // Path to the loaded file
+                    uint64_t            nHash;          // Content hash of the loaded file, zero if not computed
+                    uint64_t            nProcessed;     // Digest of the processed sample, zero if kernels built from it are not shared
+                    uint64_t            nActive;        // Digest of the active sample
                     float               fNorm;          // Norming factor
                     status_t            nStatus;
                     bool                bSync;          // Synchronize file
+                    bool                bRender;        // File needs to be re-rendered
+                    bool                bCommit;        // File has been re-rendered by the configurator and needs to be committed
+                    bool                bDeferred;      // File decoding is deferred because processed data has been found in the disk cache
                     bool                bReverse;       // Reverse impulse response
+                    bool                bAutoTrim;      // Automatically trim the tail by the energy decay curve
 
                     float               fPitch;         // Pitch amount
                     float               fHeadCut;
                     float               fTailCut;
                     float               fFadeIn;
                     float               fFadeOut;
+                    float               fTrimLevel;     // Level of the energy decay curve to trim the tail (dB)
+                    render_params_t     sRender;        // Snapshot of render parameters passed to the loader or the configurator
 
                     float               fDuration;      // Actual audio file duration
+                    float               fRT60;          // Estimated reverberation time of the processed file (s)
 
                     IRLoader           *pLoader;        // Audio file loader task
 
@@ -76,28 +128,55 @@ namespace lsp
                     plug::IPort        *pListen;
                     plug::IPort        *pStop;
                     plug::IPort        *pReverse;       // Reverse impulse response
+                    plug::IPort        *pAutoTrim;      // Automatic tail trimming
+                    plug::IPort        *pTrimLevel;     // Level of automatic tail trimming
                     plug::IPort        *pStatus;        // Status of file loading
                     plug::IPort        *pLength;        // Length of file
+                    plug::IPort        *pTrimmed;       // Length of the processed file
+                    plug::IPort        *pRT60;          // Estimated reverberation time
                     plug::IPort        *pThumbs;        // Thumbnails of file
                 } af_descriptor_t;
 
                 typedef struct channel_t
                 {
                     dspu::Bypass        sBypass;
-                    dspu::Delay         sDelay;
+                    dspu::Delay         sDryDelay;      // Dry signal delay for latency compensation
                     dspu::SamplePlayer  sPlayer;
                     dspu::Equalizer     sEqualizer;     // Wet signal equalizer
                     dspu::Playback      vPlaybacks[meta::impulse_responses_metadata::FILES_MAX];
 
-                    dspu::Convolver    *pCurr;
-                    dspu::Convolver    *pSwap;
+                    IRConvolver        *pCurr;          // Active convolver: the live one or the convolver of the bank slot, not owned
+                    IRConvolver        *pLive;          // Live convolver built from the current settings
+                    IRConvolver        *pSwap;
+                    IRConvolver        *pFade;          // Previous convolver faded out during the swap, not owned
 
                     float              *vIn;
                     float              *vOut;
                     float              *vBuffer;
+                    float              *vWet;           // Delay line of the wet signal
+                    float              *vDry;           // Delayed dry signal
+                    float              *vHistory;       // History of the input signal to prime the new convolver
+                    float              *vSwap;          // Output of the new convolver during the swap
                     float               fDryGain;
                     float               fWetGain;
                     size_t              nSource;
+                    size_t              nPredelay;      // Delay of the wet signal (samples)
+                    size_t              nBypassFade;    // Number of samples until the bypass switch completes
+                    size_t              nSilence;       // Number of samples of silent input
+                    size_t              nPrime;         // Number of samples of the history the new convolver lags behind
+                    size_t              nXFade;         // Number of samples until the crossfade to the new convolver completes
+                    size_t              nXFadeLen;      // Length of the crossfade to the new convolver
+                    bool                bSleep;         // Convolver is sleeping because of silence
+                    bool                bBypass;        // Bypass is on
+                    bool                bRebuild;       // Convolver needs to be rebuilt
+                    bool                bCommit;        // Convolver has been rebuilt by the configurator and needs to be committed
+                    bool                bWetEq;         // Wet equalization is enabled
+                    bool                bEqBake;        // Wet equalizer should be baked into the impulse response
+                    bool                bEqCommit;      // Wet equalizer is baked by the configurator into the rebuilt convolver
+                    bool                bEqBaked;       // Wet equalizer is baked into the current convolver
+                    bool                bEqLive;        // Wet equalizer is baked into the live convolver
+                    dspu::filter_params_t   vEqParams[meta::impulse_responses_metadata::EQ_BANDS + 2];  // Actual parameters of the wet equalizer
+                    dspu::filter_params_t   vEqCommit[meta::impulse_responses_metadata::EQ_BANDS + 2];  // Parameters of the wet equalizer passed to the configurator
 
                     plug::IPort        *pIn;
                     plug::IPort        *pOut;
@@ -105,9 +184,11 @@ namespace lsp
                     plug::IPort        *pSource;
                     plug::IPort        *pMakeup;
                     plug::IPort        *pActivity;
+                    plug::IPort        *pSleep;         // Sleeping indicator
                     plug::IPort        *pPredelay;
 
                     plug::IPort        *pWetEq;         // Wet equalization flag
+                    plug::IPort        *pWetBake;       // Bake wet equalizer into the impulse response
                     plug::IPort        *pLowCut;        // Low-cut flag
                     plug::IPort        *pLowFreq;       // Low-cut frequency
                     plug::IPort        *pHighCut;       // High-cut flag
@@ -115,6 +196,61 @@ namespace lsp
                     plug::IPort        *pFreqGain[meta::impulse_responses_metadata::EQ_BANDS];   // Gain for each band of the Equalizer
                 } channel_t;
 
+                typedef struct job_settings_t
+                {
+                    size_t              nRank;          // FFT rank of convolvers
+                    size_t              nLatency;       // Latency of convolvers
+                    size_t              nTailFactor;    // Sample rate reduction factor of the multi-rate tail, zero if disabled
+                    float               fTailSplit;     // Crossover point of the multi-rate tail (ms)
+                    float               fHybridSplit;   // Crossover point of the synthesized tail (ms)
+                    bool                bHybrid;        // Synthesize the tail by the feedback delay network
+                    bool                bTrueStereo;    // True stereo mode
+                    bool                bMatrix;        // The first channel owns the convolver for all channels
+                    bool                bMorph;         // Channels morph between the same tracks of both files
+                    bool                bDiskCache;     // Use the disk cache for processed samples and kernels
+                } job_settings_t;
+
+                typedef struct eq_band_t
+                {
+                    uint64_t            nType;          // Filter type
+                    uint64_t            nSlope;         // Filter slope
+                    float               fFreq;          // Filter frequency
+                    float               fFreq2;         // Second filter frequency
+                    float               fGain;          // Filter gain
+                    float               fQuality;       // Filter quality
+                } eq_band_t;
+
+                typedef struct kernel_params_t
+                {
+                    uint64_t            nDigest;        // Digest of the processed sample
+                    uint64_t            nTrack;         // Track of the sample
+                    uint64_t            nSpan;          // Span of the kernel
+                    uint64_t            nSilence;       // Number of silent samples at the head of the response
+                    uint64_t            nImmediate;     // Part of the response transformed immediately
+                    uint64_t            nFactor;        // Sample rate reduction factor of the multi-rate tail, zero if no split
+                    uint64_t            nPart;          // Part of the response: 0 - head, 1 - multi-rate tail
+                    uint64_t            nEqBake;        // Wet equalizer is baked into the response
+                    float               fSplit;         // Crossover point of the multi-rate tail (ms)
+                    float               fPad;           // Padding, always zero
+                    eq_band_t           vEq[meta::impulse_responses_metadata::EQ_BANDS + 2];  // Parameters of the baked equalizer
+                } kernel_params_t;
+
+                typedef struct kc_request_t
+                {
+                    IRKernel           *pKernel;        // Kernel to store, referenced by the request
+                    IRRegistry::kernel_key_t sKey;      // Key of the kernel
+                } kc_request_t;
+
+                typedef struct bank_slot_t
+                {
+                    IRConvolver        *vConv[IRConvolver::CHANNELS_MAX];       // Convolvers of channels
+                    bool                vEqBaked[IRConvolver::CHANNELS_MAX];    // Wet equalizer is baked into the convolver of the channel
+                    size_t              nLatency;       // Latency of convolvers
+                    size_t              nSampleRate;    // Sample rate of convolvers
+                    size_t              nSize;          // Memory occupied by convolvers (bytes)
+                    bool                bUsed;          // Slot holds convolvers
+                } bank_slot_t;
+
                 class IRLoader: public ipc::ITask
                 {
                     private:
@@ -145,6 +281,56 @@ namespace lsp
                         void        dump(dspu::IStateDumper *v) const;
                 };
 
+                class IRPreparer: public ipc::ITask
+                {
+                    private:
+                        impulse_responses          *pCore;
+
+                    public:
+                        explicit IRPreparer(impulse_responses *base);
+                        virtual ~IRPreparer() override;
+
+                    public:
+                        virtual status_t run() override;
+                        void        dump(dspu::IStateDumper *v) const;
+                };
+
+                class FileRenderer: public IRBatch
+                {
+                    private:
+                        impulse_responses          *pCore;
+                        volatile uatomic_t          nStatus;    // The first error of rendering
+
+                    public:
+                        explicit FileRenderer(impulse_responses *base);
+                        virtual ~FileRenderer() override;
+
+                    public:
+                        virtual void execute(size_t index, float *tmp) override;
+                        status_t    status() const;
+
+                        void        dump(dspu::IStateDumper *v) const;
+                };
+
+                class ChannelBuilder: public IRBatch
+                {
+                    private:
+                        impulse_responses          *pCore;
+                        uint32_t                    nPhase;     // Phase of the first convolver
+                        uint32_t                    nStep;      // Phase step between convolvers
+                        volatile uatomic_t          nStatus;    // The first error of building
+
+                    public:
+                        explicit ChannelBuilder(impulse_responses *base, uint32_t phase, uint32_t step);
+                        virtual ~ChannelBuilder() override;
+
+                    public:
+                        virtual void execute(size_t index, float *tmp) override;
+                        status_t    status() const;
+
+                        void        dump(dspu::IStateDumper *v) const;
+                };
+
                 class GCTask: public ipc::ITask
                 {
                     private:
@@ -162,44 +348,190 @@ namespace lsp
 
             protected:
                 bool                    has_active_loading_tasks();
+                size_t                  loading_mask() const;
+                size_t                  source_mask(const channel_t *c) const;
+                size_t                  channel_mask(size_t channel) const;
+                bool                    job_obsolete() const;
+                bool                    submit_configuration_task();
+                void                    cancel_configuration_task();
+                bool                    cancelled() const;
                 status_t                load(af_descriptor_t *descr);
+                status_t                decode(af_descriptor_t *descr, const char *fname);
+                bool                    make_cache_key(IRDiskCache::key_t *key, af_descriptor_t *f);
+                static void             commit_render_params(af_descriptor_t *f);
+                void                    render_thumbnails(af_descriptor_t *f, const dspu::Sample *s);
                 status_t                reconfigure();
-                void                    process_configuration_tasks();
+                status_t                render_file(af_descriptor_t *f);
+                status_t                build_channel(size_t i, uint32_t phase, uint32_t step);
+                void                    run_batch(IRBatch *batch, size_t count);
+                status_t                create_true_stereo(channel_t *c, float phase);
+                status_t                create_mono_stereo(channel_t *c, float phase);
+                status_t                create_matrix(channel_t *c, const dspu::Sample * const *samples, const size_t *tracks,
+                                            const uint64_t *digests, size_t inputs, size_t outputs, float phase);
+                bool                    make_kernel_key(IRRegistry::kernel_key_t *key, const channel_t *c,
+                                            uint64_t digest, size_t track, size_t span, size_t silence, bool split, bool tail) const;
+                status_t                create_kernel(IRKernel **k, IRKernel **tail, IRFdn **synth, const channel_t *c,
+                                            uint64_t digest, size_t track, const float *ir, size_t length, size_t span, size_t silence);
+                IRKernel               *acquire_kernel(const IRRegistry::kernel_key_t *key);
+                IRKernel               *publish_kernel(const IRRegistry::kernel_key_t *key, IRKernel *k);
+                status_t                init_kernel(IRKernel *k, IRKernel *tail, IRFdn *synth, const channel_t *c,
+                                            const float *ir, size_t length, size_t span, size_t silence);
+                status_t                build_kernel(IRKernel *k, IRKernel *tail, IRFdn *synth,
+                                            const float *ir, size_t length, size_t span, size_t silence);
+                status_t                init_split_kernel(IRKernel *k, IRKernel *tail, const float *ir, size_t length, size_t span, size_t silence);
+                status_t                init_hybrid_kernel(IRKernel *k, IRFdn *synth, const float *ir, size_t length, size_t silence);
+                size_t                  tail_split() const;
+                bool                    use_tail(size_t span) const;
+                size_t                  hybrid_split() const;
+                bool                    use_hybrid(size_t span) const;
+                size_t                  eq_bake_tail() const;
+                bool                    matrix_mode() const;
+                bool                    morph_mode() const;
+                status_t                create_morph(channel_t *c, const dspu::Sample *s, size_t file, size_t track, float phase);
+                const dspu::Sample     *get_resampled(af_descriptor_t *f, size_t sample_rate);
+                const dspu::Sample     *get_draft(dspu::Sample **draft, const dspu::Sample *af, size_t sample_rate);
+                void                    commit_settings();
+                void                    process_configuration_tasks(size_t samples);
+                bool                    render_pending() const;
+                void                    process_prepare_tasks();
+                bool                    prepare_pending() const;
+                status_t                prepare_convolvers();
+                void                    queue_kernel(IRKernel *k, const IRRegistry::kernel_key_t *key);
+                bool                    store_kernels();
                 void                    process_loading_tasks();
                 void                    process_gc_events();
                 void                    process_listen_events();
                 void                    perform_convolution(size_t samples);
+                void                    convolve(channel_t *c, float * const *dst, const float * const *src, size_t count);
+                void                    swap_convolver(channel_t *c, float * const *dst, const float * const *src, size_t count);
+                void                    begin_swap(channel_t *c);
+                bool                    swap_active() const;
+                void                    process_bank_events();
+                bool                    submit_store_task();
+                void                    commit_store();
+                bool                    slot_ready(size_t slot) const;
+                void                    select_slot(size_t slot);
+                void                    activate(channel_t *c, IRConvolver *cv, bool eq_baked);
+                void                    commit_latency();
+                size_t                  bank_size(size_t skip) const;
+                void                    destroy_slot(bank_slot_t *b);
+                void                    record_history(size_t count);
                 void                    output_parameters();
                 void                    perform_gc();
+                void                    recycle_samples(dspu::Sample *gc_list);
+                void                    recycle_sample(dspu::Sample * &s);
 
             protected:
                 static void             destroy_samples(dspu::Sample *gc_list);
                 static void             destroy_sample(dspu::Sample * &s);
-                static void             destroy_convolver(dspu::Convolver * &c);
-                static void             destroy_file(af_descriptor_t *af);
+                static void             destroy_convolver(IRConvolver * &c);
+                void                    destroy_file(af_descriptor_t *af);
+                void                    drop_cache(af_descriptor_t *af);
+                void                    release_shared(dspu::Sample * &s);
                 static void             destroy_channel(channel_t *c);
                 static size_t           get_fft_rank(size_t rank);
+                static size_t           get_latency(size_t latency, size_t rank);
+                static size_t           get_tail_factor(size_t factor);
+                static const dspu::Sample *get_committed(const af_descriptor_t *f);
+                static uint64_t         committed_digest(const af_descriptor_t *f);
+                static void             destroy_kernel(IRKernel * &k);
+                static void             destroy_synth(IRFdn * &s);
+                static void             update_equalizer(channel_t *c);
+                static bool             playback_active(const channel_t *c);
 
             protected:
                 IRConfigurator          sConfigurator;
+                IRPreparer              sPreparer;      // Task which transforms the rest of live convolvers
                 GCTask                  sGCTask;
-
-                size_t                  nChannels;
+                IRDiskCache             sDiskCache;
+                IRWorker                sWorker;        // Worker thread for tail partitions of convolvers
+                IRRegistry             *pRegistry;      // Registry of data shared between instances
+                IRPool                 *pPool;          // Threads which transform partitions of kernels, shared between instances
+                IRArena                 sArena;         // Memory of kernels, convolvers and samples reused by reconfigurations
+                kc_request_t            vKCQueue[KC_QUEUE_SIZE];    // Kernels built by the configurator to be stored to the disk cache by the preparer
+                volatile uatomic_t      nKCQueue;       // Number of kernels in the queue
+
+                size_t                  nChannels;      // Number of output channels
+                size_t                  nInputs;        // Number of input channels
+                size_t                  nFiles;         // Number of impulse response files
                 channel_t              *vChannels;
                 af_descriptor_t        *vFiles;
                 ipc::IExecutor         *pExecutor;
                 size_t                  nReconfigReq;
                 size_t                  nReconfigResp;
+                uatomic_t               nCancel;        // Request to stop the running reconfiguration
+                size_t                  nJobFiles;      // Bit mask of files used by the running configurator
+                job_settings_t          sJob;           // Snapshot of settings used by the running configurator
+                size_t                  nJobsDone;      // Number of completed reconfiguration jobs
+                size_t                  nJobsCancelled; // Number of cancelled reconfiguration jobs
+                size_t                  nSettleReq;     // Last reconfiguration request seen by the settle timer
+                size_t                  nSettle;        // Time left until the settings are considered stable (samples)
+                bool                    bPreview;       // The configurator renders the truncated preview of files
+                bool                    bRefine;        // The preview is active and should be replaced by the full render
                 float                   fGain;
                 size_t                  nRank;
+                size_t                  nLatency;       // Latency of the convolution engine
+                size_t                  nDelay;         // Latency of the active convolvers reported to the host (samples)
+                size_t                  nImmediate;     // Part of the response transformed before the convolver goes live (samples)
+                bool                    bTrueStereo;    // True stereo mode
+                bool                    bDiskCache;     // Use disk cache
+                size_t                  nTailFactor;    // Sample rate reduction factor of the multi-rate tail, zero if disabled
+                float                   fTailSplit;     // Crossover point of the multi-rate tail (ms)
+                bool                    bHybrid;        // Synthesize the tail by the feedback delay network
+                float                   fHybridSplit;   // Crossover point of the synthesized tail (ms)
+                size_t                  nXFade;         // Crossfade time between the old and the new convolver (samples)
+                size_t                  nHistPos;       // Write position in the history of the input signal
+                size_t                  nHistFill;      // Number of samples in the history of the input signal
+                size_t                  nWetPos;        // Write position in delay lines of the wet signal
+                bool                    bMorph;         // Morph between the same tracks of both files
+                float                   fMorph;         // Morph weight of the second file
+                bank_slot_t             vBank[meta::impulse_responses_metadata::BANK_SLOTS];   // Bank of stored convolvers
+                dspu::Toggle            sBankStore;     // Store toggle of the bank
+                dspu::Toggle            sBankClear;     // Clear toggle of the bank
+                size_t                  nSlot;          // Active slot of the bank, zero for live convolvers
+                size_t                  nSlotReq;       // Requested slot of the bank
+                size_t                  nBankTarget;    // Slot of the bank to store or clear
+                size_t                  nStoreReq;      // Slot requested to be stored, zero if none
+                size_t                  nStoreSlot;     // Slot being stored by the configurator, zero if none
+                size_t                  nClearReq;      // Slot requested to be cleared, zero if none
+                size_t                  nBankLimit;     // Memory limit of the bank (bytes)
+                status_t                nBankStatus;    // Status of the last store operation
+                volatile uatomic_t      nCacheClock;    // Access clock of the resample cache
+                volatile uatomic_t      nCacheHits;     // Number of resample cache hits
+                volatile uatomic_t      nCacheMisses;   // Number of resample cache misses
                 dspu::Sample           *pGCList;        // Garbage collection list
 
                 plug::IPort            *pBypass;
                 plug::IPort            *pRank;
+                plug::IPort            *pLatency;
                 plug::IPort            *pDry;
                 plug::IPort            *pWet;
                 plug::IPort            *pDryWet;
                 plug::IPort            *pOutGain;
+                plug::IPort            *pDiskCache;
+                plug::IPort            *pCacheHits;     // Hit rate of the resample cache
+                plug::IPort            *pTrueStereo;
+                plug::IPort            *pMorph;         // Morph switch
+                plug::IPort            *pMorphAmount;   // Morph between impulse files
+                plug::IPort            *pTailOn;        // Multi-rate tail switch
+                plug::IPort            *pTailSplit;     // Crossover point of the multi-rate tail
+                plug::IPort            *pTailFactor;    // Sample rate reduction of the multi-rate tail
+                plug::IPort            *pTailSaving;    // Estimated CPU saving of the multi-rate tail
+                plug::IPort            *pHybrid;        // Hybrid tail synthesis switch
+                plug::IPort            *pHybridSplit;   // Crossover point of the synthesized tail
+                plug::IPort            *pHybridError;   // Spectral error of the synthesized tail
+                plug::IPort            *pXFade;         // Crossfade time between impulse responses
+                plug::IPort            *pSwapLoad;      // Temporary load of the impulse response swap
+                plug::IPort            *pJobsDone;      // Number of completed reconfiguration jobs
+                plug::IPort            *pJobsCancelled; // Number of cancelled reconfiguration jobs
+                plug::IPort            *pBankSlot;      // Active slot of the bank
+                plug::IPort            *pBankTarget;    // Slot of the bank to store or clear
+                plug::IPort            *pBankStore;     // Store the live convolvers to the bank
+                plug::IPort            *pBankClear;     // Clear the slot of the bank
+                plug::IPort            *pBankLimit;     // Memory limit of the bank
+                plug::IPort            *pBankStatus;    // Status of the last store operation
+                plug::IPort            *pBankUsage;     // Memory usage of the bank
+                plug::IPort            *pSharedMemory;  // Memory occupied by impulse responses shared between instances
 
                 uint8_t                *pData;
 
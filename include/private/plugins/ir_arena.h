@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_ARENA_H_
+#define PRIVATE_PLUGINS_IR_ARENA_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Arena of memory blocks and samples reused between reconfigurations of one instance.
+         * Released blocks are kept in the free list and returned by next requests of the
+         * similar size, so rebuilding kernels and convolvers of the same layout does not
+         * touch the heap. Released samples are kept for rendering of files of the similar
+         * length. The arena is thread-safe but should not be used by the real-time thread.
+         */
+        class IRArena
+        {
+            public:
+                static constexpr size_t SAMPLES_MAX     = 8;        // Maximum number of spare samples
+
+            private:
+                typedef struct block_t
+                {
+                    block_t            *pNext;          // Next block in the free list
+                    size_t              nSize;          // Size of the block available to the user
+                    size_t              nEpoch;         // Epoch of the arena when the block has been released
+                    uint8_t            *pRaw;           // Pointer returned by the allocator
+                } block_t;
+
+                static constexpr size_t HEADER_SIZE     = (sizeof(block_t) + DEFAULT_ALIGN - 1) & ~size_t(DEFAULT_ALIGN - 1);
+
+            private:
+                mutable ipc::Mutex  sLock;
+                block_t            *pFree;          // List of released blocks
+                size_t              nFree;          // Amount of memory in released blocks
+                size_t              nUsed;          // Amount of memory in acquired blocks
+                size_t              nAllocs;        // Number of heap allocations
+                size_t              nReuses;        // Number of reused blocks and samples
+                size_t              nEpoch;         // Number of trims
+                dspu::Sample       *vSamples[SAMPLES_MAX];  // Spare samples
+                size_t              vEpochs[SAMPLES_MAX];   // Epochs of the arena when spare samples have been released
+
+            protected:
+                static block_t     *header(uint8_t *ptr);
+                static void         free_list(block_t *list);
+                static void         destroy_sample(dspu::Sample *s);
+
+            public:
+                IRArena();
+                IRArena(const IRArena &) = delete;
+                IRArena(IRArena &&) = delete;
+                ~IRArena();
+
+                IRArena & operator = (const IRArena &) = delete;
+                IRArena & operator = (IRArena &&) = delete;
+
+            public:
+                /**
+                 * Acquire the block of memory aligned to DEFAULT_ALIGN
+                 * @param arena arena to take the block from, the block is allocated on the heap if NULL
+                 * @param bytes number of bytes
+                 * @return pointer to the block or NULL if there is no memory
+                 */
+                static uint8_t     *acquire(IRArena *arena, size_t bytes);
+
+                /**
+                 * Release the block of memory
+                 * @param arena arena the block has been acquired from, may be NULL
+                 * @param ptr pointer to the block, may be NULL
+                 */
+                static void         release(IRArena *arena, uint8_t *ptr);
+
+                /**
+                 * Take the spare sample of the specified size or allocate new one
+                 * @param channels number of channels
+                 * @param length length of the sample
+                 * @return sample or NULL if there is no memory
+                 */
+                dspu::Sample       *acquire_sample(size_t channels, size_t length);
+
+                /**
+                 * Keep the sample for reuse, destroy it if there are too many spare samples
+                 * @param s sample to release, may be NULL
+                 */
+                void                release_sample(dspu::Sample *s);
+
+                /**
+                 * Free released blocks and spare samples which have not been reused since the previous
+                 * call, so memory released by one reconfiguration stays available to the next one
+                 */
+                void                trim();
+
+                /**
+                 * Free all released blocks and spare samples
+                 */
+                void                destroy();
+
+            public:
+                inline size_t       allocs() const          { return nAllocs;               }
+                inline size_t       reuses() const          { return nReuses;               }
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_ARENA_H_ */
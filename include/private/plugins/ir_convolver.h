@@ -0,0 +1,336 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_CONVOLVER_H_
+#define PRIVATE_PLUGINS_IR_CONVOLVER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+#include <private/plugins/ir_fdn.h>
+#include <private/plugins/ir_kernel.h>
+#include <private/plugins/ir_resampler.h>
+#include <private/plugins/ir_worker.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Non-uniform partitioned convolver. Holds the streaming state only, the
+         * impulse response data is provided by the kernels. Each level uses the
+         * overlap-save method with the frequency-domain delay line of input spectra.
+         *
+         * The convolver can process several inputs and outputs with a kernel for each
+         * input to output path. The spectrum of each input is computed once and the
+         * products are accumulated in the frequency domain, so each output requires
+         * only one reverse FFT.
+         *
+         * Large levels which start at least two blocks later can be processed by the
+         * worker thread: the level computes the output one block in advance, so the
+         * worker has the whole block of time to complete the job. If the worker is still
+         * executing the job at the deadline, the level outputs silence for the block and
+         * applies the skipped input frame when the worker releases the level.
+         *
+         * Inactive partitions of kernels are skipped, levels without active partitions
+         * are not processed at all. The leading silence of kernels is replaced by the
+         * pure delay of inputs.
+         *
+         * The late part of the response can be processed by the tail convolver at the
+         * sample rate reduced by the integer factor: inputs are downsampled, convolved
+         * with decimated kernels and upsampled back to the output.
+         *
+         * Alternatively, the late part of each path can be synthesized by the feedback
+         * delay network fitted to the response.
+         *
+         * Each path can have the second kernel to morph between two responses: products
+         * of both kernels with the same input spectrum are accumulated with weights, so
+         * the morph can be changed at any time without rebuilding the convolver.
+         *
+         * Kernels can be used before all levels are transformed: spectra of inputs are
+         * computed for all levels, but only levels which are ready contribute to the output.
+         */
+        class IRConvolver
+        {
+            public:
+                static constexpr size_t CHANNELS_MAX    = 2;    // Maximum number of inputs and outputs
+
+            private:
+                class LevelJob;
+
+                typedef struct level_t
+                {
+                    size_t                      nIndex;         // Index of the level in kernels
+                    size_t                      nRank;          // FFT rank
+                    size_t                      nBlock;         // Block size
+                    size_t                      nFirst;         // Index of the first partition
+                    size_t                      nParts;         // Number of partitions up to the last active one
+                    float                      *vFrame[CHANNELS_MAX];   // Input frames: previous and current block
+                    float                      *vOut[CHANNELS_MAX];     // Outputs of the level for the current block
+                    float                      *vHistory[CHANNELS_MAX]; // Frequency-domain delay lines of input spectra
+                    size_t                      nHistory;       // Number of spectra in the delay line
+                    size_t                      nHead;          // Position of the most recent spectrum in the delay line
+                    size_t                      nFill;          // Number of samples in the current block
+                    size_t                      nLag;           // Number of blocks between the input frame and the computed output
+                    float                       fMorph;         // Morph weight applied to the current block
+                    LevelJob                   *pJob;           // Job for the worker thread, NULL if the level is processed in place
+                    float                      *vPending[CHANNELS_MAX]; // Input frame of the last block skipped while the worker was late
+                    size_t                      nDropped;       // Number of skipped frames before the pending one, replaced by silence
+                    bool                        bPending;       // The pending frame should be applied
+                    bool                        bClear;         // The state should be cleared after the worker releases the level
+                } level_t;
+
+                class LevelJob: public IRJob
+                {
+                    private:
+                        friend class IRConvolver;
+
+                    private:
+                        IRConvolver        *pCore;          // Convolver
+                        level_t            *pLevel;         // Level
+                        float              *vInput[CHANNELS_MAX];   // Copies of input frames
+                        float              *vResult[CHANNELS_MAX];  // Outputs of the level
+                        float              *vAcc;           // Spectrum accumulator
+                        float              *vTemp;          // Temporary buffer
+
+                    public:
+                        explicit LevelJob(IRConvolver *core, level_t *level);
+                        virtual ~LevelJob() override;
+
+                    public:
+                        virtual void        execute() override;
+                };
+
+            private:
+                IRKernel           *vKernels[CHANNELS_MAX * CHANNELS_MAX];    // Kernels of paths, index is input * CHANNELS_MAX + output
+                IRWorker           *pWorker;        // Worker thread
+                IRConvolver        *pTail;          // Convolver of the tail at the reduced sample rate
+                IRResampler        *vDown[CHANNELS_MAX];    // Downsamplers of inputs of the tail
+                IRResampler        *vUp[CHANNELS_MAX];      // Upsamplers of outputs of the tail
+                float              *vTailIn[CHANNELS_MAX];  // Downsampled inputs of the tail
+                float              *vTailOut[CHANNELS_MAX]; // Outputs of the tail before upsampling
+                size_t              nFactor;        // Sample rate reduction factor of the tail
+                float               fSaving;        // Estimated relative reduction of computations by the tail convolver
+                IRFdn              *vSynth[CHANNELS_MAX * CHANNELS_MAX];      // Networks which synthesize the tail of paths
+                IRKernel           *vMorph[CHANNELS_MAX * CHANNELS_MAX];      // Kernels of the second response to morph
+                float              *vMixHead[CHANNELS_MAX * CHANNELS_MAX];    // Direct heads mixed by the morph weight
+                float               fMorph;         // Morph weight: 0 - the first response, 1 - the second response
+                float               fHeadMorph;     // Morph weight of mixed direct heads
+                bool                bMorph;         // The convolver morphs between two responses
+                size_t              nSynth;         // Number of networks
+                size_t              nInputs;        // Number of inputs
+                size_t              nOutputs;       // Number of outputs
+                size_t              nLatency;       // Latency
+                size_t              nLength;        // Length of the response including latency
+                size_t              nDelay;         // Pure delay of inputs
+                size_t              nDelayPos;      // Write position in the delay lines
+                size_t              nHead;          // Size of the direct head
+                size_t              nLevels;        // Number of levels
+                level_t             vLevels[IRKernel::LEVELS_MAX];
+                float              *vDirect[CHANNELS_MAX];  // Accumulators of the direct head
+                float              *vDelay[CHANNELS_MAX];   // Delay lines of inputs
+                float              *vDelayed[CHANNELS_MAX]; // Delayed inputs of the current chunk
+                float              *vAcc;           // Spectrum accumulator
+                float              *vTemp;          // Temporary buffer
+                size_t              nMisses;        // Number of jobs executed by the real-time thread after the deadline
+                size_t              nSkips;         // Number of blocks skipped by levels because the worker was late
+                size_t              nSize;          // Size of allocated data in bytes
+                IRArena            *pArena;         // Arena of memory blocks, may be NULL
+                uint8_t            *pData;
+
+            protected:
+                bool                create(IRKernel * const *kernels, IRKernel * const *morph, IRKernel * const *tail, size_t factor,
+                                        size_t inputs, size_t outputs, float phase, IRWorker *worker);
+                void                transform(level_t *l, float * const *frames, float * const *outs, float *acc, float *tmp);
+                size_t              accumulate(float *acc, float *tmp, const level_t *l, const float *hist,
+                                        const IRKernel *k, float weight, size_t first, size_t n);
+                void                mix_heads();
+                void                process_block(level_t *l);
+                void                catch_up(level_t *l);
+                static void         push_silence(level_t *l, size_t inputs);
+                void                delay_inputs(const float **dst, const float * const *src, size_t count);
+                void                process_tail(float * const *dst, const float * const *src, size_t count);
+                void                process_synth(float * const *dst, const float * const *src, size_t count);
+                float               estimate_cost(size_t stretch) const;
+
+            public:
+                IRConvolver();
+                explicit IRConvolver(IRArena *arena);
+                IRConvolver(const IRConvolver &) = delete;
+                IRConvolver(IRConvolver &&) = delete;
+                ~IRConvolver();
+
+                IRConvolver & operator = (const IRConvolver &) = delete;
+                IRConvolver & operator = (IRConvolver &&) = delete;
+
+            public:
+                /**
+                 * Initialize single-input, single-output convolver
+                 * @param kernel initialized kernel, the convolver takes the reference to it on success
+                 * @param phase initial phase of block processing in range [0..1), allows to
+                 *   distribute the FFT load between several convolvers
+                 * @param worker worker thread to process large levels, may be NULL
+                 * @return true on success
+                 */
+                bool                init(IRKernel *kernel, float phase, IRWorker *worker);
+
+                /**
+                 * Initialize multiple-input, multiple-output convolver
+                 * @param kernels matrix of inputs * CHANNELS_MAX kernels, the kernel of the path from
+                 *   input i to output o has index i * CHANNELS_MAX + o, NULL kernel means silent path;
+                 *   all kernels should be compatible, the convolver takes references to them on success
+                 * @param inputs number of inputs
+                 * @param outputs number of outputs
+                 * @param phase initial phase of block processing in range [0..1)
+                 * @param worker worker thread to process large levels, may be NULL
+                 * @return true on success
+                 */
+                bool                init(IRKernel * const *kernels, size_t inputs, size_t outputs, float phase, IRWorker *worker);
+
+                /**
+                 * Initialize single-input, single-output convolver with the tail processed at the reduced sample rate
+                 * @param kernel initialized kernel, the convolver takes the reference to it on success
+                 * @param tail initialized kernel of the decimated tail, may be NULL, the convolver takes the reference to it on success
+                 * @param factor sample rate reduction factor of the tail
+                 * @param phase initial phase of block processing in range [0..1)
+                 * @param worker worker thread to process large levels, may be NULL
+                 * @return true on success
+                 */
+                bool                init(IRKernel *kernel, IRKernel *tail, size_t factor, float phase, IRWorker *worker);
+
+                /**
+                 * Initialize multiple-input, multiple-output convolver with the tail processed at the reduced sample rate
+                 * @param kernels matrix of inputs * CHANNELS_MAX kernels, see above
+                 * @param tail matrix of inputs * CHANNELS_MAX kernels of the decimated tail with the same layout, NULL if
+                 *   there is no tail, all kernels of the tail should be compatible
+                 * @param factor sample rate reduction factor of the tail
+                 * @param inputs number of inputs
+                 * @param outputs number of outputs
+                 * @param phase initial phase of block processing in range [0..1)
+                 * @param worker worker thread to process large levels, may be NULL
+                 * @return true on success
+                 */
+                bool                init(IRKernel * const *kernels, IRKernel * const *tail, size_t factor,
+                                        size_t inputs, size_t outputs, float phase, IRWorker *worker);
+
+                /**
+                 * Initialize single-input, single-output convolver which morphs between two responses
+                 * @param kernel initialized kernel of the first response, the convolver takes the reference to it on success
+                 * @param morph initialized kernel of the second response compatible with the first one,
+                 *   the convolver takes the reference to it on success
+                 * @param phase initial phase of block processing in range [0..1)
+                 * @param worker worker thread to process large levels, may be NULL
+                 * @return true on success
+                 */
+                bool                init_morph(IRKernel *kernel, IRKernel *morph, float phase, IRWorker *worker);
+
+                /**
+                 * Set the morph weight, should be called by the real-time thread only. The weight
+                 * is applied to each partition level at the start of its next block
+                 * @param morph morph weight in range [0..1]: 0 - the first response, 1 - the second response
+                 */
+                void                set_morph(float morph);
+
+                /**
+                 * Set networks which synthesize the tail of paths, should be called after init()
+                 * @param synth matrix of inputs * CHANNELS_MAX networks with the same layout as kernels,
+                 *   NULL network means that the path has no synthesized tail, the convolver takes ownership of them
+                 */
+                void                set_synth(IRFdn * const *synth);
+
+                /**
+                 * Transform partitions of the next level of kernels which is not ready yet, levels
+                 * are prepared in the order of their offsets for all paths. Can be called by the
+                 * background thread while the convolver is processed
+                 * @param pool pool of threads which transform partitions in parallel, may be NULL
+                 * @return true on success, false if there is no memory
+                 */
+                bool                prepare(IRPool *pool);
+
+                /**
+                 * Check that all levels of all kernels are ready
+                 * @return true if all levels of all kernels are ready
+                 */
+                bool                prepared() const;
+
+                /**
+                 * Destroy convolver and kernels, waits until the worker thread releases all jobs
+                 */
+                void                destroy();
+
+                /**
+                 * Clear the processing state as if the convolver received silence for the whole
+                 * length of the response, does not wait for the worker: levels processed by the
+                 * worker are cleared when it releases them. Should be called by the real-time thread only.
+                 */
+                void                clear();
+
+                /**
+                 * Process data of single-input, single-output convolver
+                 * @param dst destination buffer
+                 * @param src source buffer
+                 * @param count number of samples to process
+                 */
+                void                process(float *dst, const float *src, size_t count);
+
+                /**
+                 * Process data of multiple-input, multiple-output convolver
+                 * @param dst list of destination buffers for each output
+                 * @param src list of source buffers for each input
+                 * @param count number of samples to process
+                 */
+                void                process(float * const *dst, const float * const *src, size_t count);
+
+            public:
+                inline size_t           inputs() const      { return nInputs;       }
+                inline size_t           outputs() const     { return nOutputs;      }
+                inline size_t           latency() const     { return nLatency;      }
+                inline size_t           length() const      { return nLength;       }
+                inline size_t           delay() const       { return nDelay;        }
+                inline size_t           misses() const      { return nMisses;       }
+                inline size_t           skips() const       { return nSkips;        }
+                inline size_t           factor() const      { return nFactor;       }
+                inline float            saving() const      { return fSaving;       }
+                inline bool             synthetic() const   { return nSynth > 0;    }
+                inline bool             morphing() const    { return bMorph;        }
+                inline float            morph() const       { return fMorph;        }
+
+                /**
+                 * Get the mean spectral error of networks which synthesize the tail
+                 * @return mean spectral error (dB)
+                 */
+                float                   synth_error() const;
+
+                /**
+                 * Get the amount of memory occupied by the convolver including kernels,
+                 * the tail convolver and networks
+                 * @return amount of memory in bytes
+                 */
+                size_t                  size() const;
+                inline const IRKernel  *kernel(size_t in, size_t out) const { return vKernels[in * CHANNELS_MAX + out]; }
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_CONVOLVER_H_ */
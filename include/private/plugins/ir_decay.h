@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_DECAY_H_
+#define PRIVATE_PLUGINS_IR_DECAY_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Result of the energy decay analysis of the impulse response
+         */
+        typedef struct ir_decay_t
+        {
+            size_t              nLength;        // Length of the response until the energy decays below the threshold
+            float               fRT60;          // Estimated reverberation time (s), zero if can not be estimated
+        } ir_decay_t;
+
+        /**
+         * Analyze the Schroeder energy decay curve of the impulse response. The energy of all
+         * channels is summed. The reverberation time is estimated by the linear fit of the
+         * decay curve in the range between -5 dB and -25 dB (T20).
+         *
+         * @param res pointer to store the result
+         * @param s impulse response
+         * @param threshold threshold of the decay curve to compute the length (dB)
+         * @param sample_rate sample rate of the impulse response
+         */
+        void analyze_decay(ir_decay_t *res, const dspu::Sample *s, float threshold, size_t sample_rate);
+
+        /**
+         * Estimate the reverberation time (T20) of the single-channel signal from its
+         * Schroeder energy decay curve
+         *
+         * @param src signal
+         * @param length length of the signal
+         * @param sample_rate sample rate of the signal
+         * @return estimated reverberation time (s), zero if can not be estimated
+         */
+        float decay_time(const float *src, size_t length, size_t sample_rate);
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_DECAY_H_ */
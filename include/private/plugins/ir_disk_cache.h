@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_DISK_CACHE_H_
+#define PRIVATE_PLUGINS_IR_DISK_CACHE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/io/NativeFile.h>
+#include <lsp-plug.in/io/Path.h>
+
+#include <private/plugins/ir_kernel.h>
+#include <private/plugins/ir_registry.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Persistent on-disk cache of processed impulse responses. There are two kinds of entries:
+         *   - processed samples which are bound to the sample player and used for thumbnails,
+         *     the entry consists of the header and channel data aligned to DEFAULT_ALIGN;
+         *   - images of prepared kernels, the entry consists of the header, the layout of the kernel
+         *     and the data block aligned to DEFAULT_ALIGN. The entry is memory-mapped on load and the
+         *     kernel is attached to the mapped data, so partitions are not transformed again.
+         *
+         * Entries are written to unique temporary files and renamed into place, so readers never see
+         * partially written entries. The total size of entries is limited, the least recently used
+         * entries are removed after each store.
+         */
+        class IRDiskCache
+        {
+            public:
+                typedef struct key_t
+                {
+                    uint64_t            nHash;          // Content hash of the audio file
+                    uint32_t            nSampleRate;    // Sample rate of processed data
+                    uint32_t            nReverse;       // Reverse flag
+                    float               fPitch;         // Pitch (st)
+                    float               fHeadCut;       // Head cut (ms)
+                    float               fTailCut;       // Tail cut (ms)
+                    float               fFadeIn;        // Fade in (ms)
+                    float               fFadeOut;       // Fade out (ms)
+                    uint32_t            nAutoTrim;      // Automatic tail trimming flag
+                    float               fTrimLevel;     // Level of automatic tail trimming (dB)
+                    uint32_t            nPadding;       // Padding, should be zero
+                } key_t;
+
+                typedef struct info_t
+                {
+                    float               fNorm;          // Norming factor of the original file
+                    float               fDuration;      // Duration of the original file after resampling (s)
+                    float               fRT60;          // Estimated reverberation time of the processed data (s)
+                    uint32_t            nPadding;       // Padding, should be zero
+                } info_t;
+
+            private:
+                io::Path            sBase;          // Base directory of the cache
+                bool                bInit;          // Initialization flag
+
+            protected:
+                status_t            get_location(io::Path *path, const void *key, size_t bytes, const char *ext) const;
+                status_t            create_temporary(io::NativeFile *fd, io::Path *path, const io::Path *dst) const;
+                status_t            commit(io::NativeFile *fd, const io::Path *tmp, const io::Path *dst, status_t res) const;
+                void                trim() const;
+
+            public:
+                IRDiskCache();
+                IRDiskCache(const IRDiskCache &) = delete;
+                IRDiskCache(IRDiskCache &&) = delete;
+                ~IRDiskCache();
+
+                IRDiskCache & operator = (const IRDiskCache &) = delete;
+                IRDiskCache & operator = (IRDiskCache &&) = delete;
+
+            public:
+                /**
+                 * Initialize cache, determine and create the cache directory of the user
+                 * @return status of operation
+                 */
+                status_t            init();
+
+                /**
+                 * Compute content hash of the file
+                 * @param hash pointer to store hash value
+                 * @param path path to the file
+                 * @return status of operation
+                 */
+                static status_t     hash_file(uint64_t *hash, const char *path);
+
+                /**
+                 * Compute hash of the plain memory
+                 * @param data pointer to the data
+                 * @param count number of bytes
+                 * @return hash value
+                 */
+                static uint64_t     digest(const void *data, size_t count);
+
+                /**
+                 * Initialize the key
+                 * @param key key to initialize
+                 */
+                static void         init_key(key_t *key);
+
+                /**
+                 * Load processed sample from cache
+                 * @param dst pointer to store the sample, should be destroyed by the caller
+                 * @param info pointer to store additional information about the sample
+                 * @param key the key of the sample
+                 * @return status of operation, STATUS_NOT_FOUND if there is no cache entry
+                 */
+                status_t            load(dspu::Sample **dst, info_t *info, const key_t *key) const;
+
+                /**
+                 * Store processed sample to cache
+                 * @param s sample to store
+                 * @param info additional information about the sample
+                 * @param key the key of the sample
+                 * @return status of operation
+                 */
+                status_t            store(const dspu::Sample *s, const info_t *info, const key_t *key) const;
+
+                /**
+                 * Load the image of the prepared kernel from cache, the kernel is attached to the memory-mapped file
+                 * @param dst pointer to store the kernel, should be released by the IRKernel::release() call
+                 * @param key the key of the kernel
+                 * @return status of operation, STATUS_NOT_FOUND if there is no cache entry
+                 */
+                status_t            load_kernel(IRKernel **dst, const IRRegistry::kernel_key_t *key) const;
+
+                /**
+                 * Store the image of the prepared kernel to cache
+                 * @param k kernel to store, should be prepared
+                 * @param key the key of the kernel
+                 * @return status of operation
+                 */
+                status_t            store_kernel(const IRKernel *k, const IRRegistry::kernel_key_t *key) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_DISK_CACHE_H_ */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_FDN_H_
+#define PRIVATE_PLUGINS_IR_FDN_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Feedback delay network which synthesizes the late tail of the impulse response.
+         * Delay lines are mixed by the orthogonal Hadamard matrix, each line has the one-pole
+         * absorption filter which matches the reverberation time of the low and the high band
+         * of the response. The output passes the two-band tone filter which matches the energy
+         * of bands. The input is delayed, so the output starts at the crossover point.
+         */
+        class IRFdn
+        {
+            public:
+                static constexpr size_t LINES       = 8;        // Number of delay lines
+
+            private:
+                size_t              vLength[LINES]; // Lengths of delay lines
+                float               vGain[LINES];   // Input gains of absorption filters
+                float               vPole[LINES];   // Poles of absorption filters
+                float               vState[LINES];  // States of absorption filters
+                float              *vLines;         // Delay lines, each of nLineSize samples
+                float              *vPre;           // Delay line of the input
+                size_t              nLineSize;      // Size of each delay line, power of two
+                size_t              nPreSize;       // Size of the delay line of the input, power of two
+                size_t              nPos;           // Write position in delay lines
+                size_t              nPrePos;        // Write position in the delay line of the input
+                size_t              nPreDelay;      // Delay of the input
+                size_t              nLength;        // Length of the synthesized response including the delay
+                float               fTone;          // Coefficient of the low-pass filter of the tone control
+                float               fToneState;     // State of the low-pass filter of the tone control
+                float               fLowGain;       // Gain of the low band
+                float               fHighGain;      // Gain of the high band
+                float               fLowRT60;       // Reverberation time of the low band (s)
+                float               fHighRT60;      // Reverberation time of the high band (s)
+                float               fError;         // Mean spectral error of the fit (dB)
+                uint8_t            *pData;
+
+            protected:
+                inline float        step(float x);
+                void                set_decay(float low, float high, size_t sample_rate);
+                void                reset();
+                void                render(float *dst, size_t delay, size_t count);
+
+            public:
+                IRFdn();
+                IRFdn(const IRFdn &) = delete;
+                IRFdn(IRFdn &&) = delete;
+                ~IRFdn();
+
+                IRFdn & operator = (const IRFdn &) = delete;
+                IRFdn & operator = (IRFdn &&) = delete;
+
+            public:
+                /**
+                 * Fit the network to the tail of the impulse response. Measures the reverberation
+                 * time and the energy of the low and the high band of the tail, then renders the
+                 * response of the network and measures the spectral error. Not real-time safe.
+                 *
+                 * @param ir impulse response
+                 * @param length length of the impulse response
+                 * @param split crossover point, the start of the synthesized tail
+                 * @param latency latency of the convolver which processes the early part
+                 * @param sample_rate sample rate
+                 * @return status of operation
+                 */
+                status_t            fit(const float *ir, size_t length, size_t split, size_t latency, size_t sample_rate);
+
+                /**
+                 * Destroy the network
+                 */
+                void                destroy();
+
+                /**
+                 * Clear the state of the network
+                 */
+                void                clear();
+
+                /**
+                 * Process the signal and add the synthesized tail to the destination buffer
+                 * @param dst destination buffer
+                 * @param src source buffer
+                 * @param count number of samples to process
+                 */
+                void                process(float *dst, const float *src, size_t count);
+
+            public:
+                inline size_t       length() const      { return nLength;       }
+                inline float        error() const       { return fError;        }
+                inline size_t       size() const        { return (nLineSize * LINES + nPreSize) * sizeof(float); }
+
+                /**
+                 * Get the minimum crossover point which can be aligned with the network
+                 * @param sample_rate sample rate
+                 * @return minimum crossover point in samples
+                 */
+                static size_t       min_split(size_t sample_rate);
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_FDN_H_ */
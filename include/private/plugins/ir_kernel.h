@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_KERNEL_H_
+#define PRIVATE_PLUGINS_IR_KERNEL_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+
+#include <private/plugins/ir_arena.h>
+#include <private/plugins/ir_pool.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        class IRRegistry;
+
+        /**
+         * Immutable frequency-domain representation of the impulse response for
+         * the non-uniform partitioned convolution. The impulse response is split into:
+         *   - direct head which is convolved in time domain to provide zero latency;
+         *   - levels of uniform partitions, each next level has partitions twice larger
+         *     than the previous one until the maximum partition size is reached.
+         *
+         * Each level with block size B starts at the offset which is a multiple of B and
+         * not less than B, so the output of the level for the next block can be computed
+         * at the end of the current block without introducing any latency.
+         *
+         * If latency is allowed, the impulse response is considered to be delayed by the
+         * latency value and the direct head is replaced by larger partitions.
+         *
+         * Leading silence of the impulse response is not convolved: the layout starts at the
+         * largest power of two offset that fits the silence and the latency, the remainder
+         * should be applied as a pure delay of the input. Partitions with negligible energy
+         * are marked inactive and should be skipped by the convolver.
+         *
+         * Levels beyond the specified offset can be transformed later by the background
+         * thread while the kernel is in use: the convolver should apply only levels which
+         * are reported to be ready. Until then the slot of each partition keeps its
+         * time-domain data, partitions are transformed in place without extra copies.
+         *
+         * The kernel is reference counted and can be shared by convolvers of several instances
+         * through the registry, levels are prepared by one thread at a time.
+         *
+         * The prepared kernel can be exported as the image: the layout descriptor and the plain
+         * block of data. The kernel can be attached to the image stored in external read-only
+         * memory, for example in the memory-mapped file, without copying and transforming it.
+         */
+        class IRKernel
+        {
+            public:
+                static constexpr size_t HEAD_RANK       = 6;                // Rank of the direct head
+                static constexpr size_t HEAD_SIZE       = 1 << HEAD_RANK;   // Size of the direct head
+                static constexpr size_t LEVELS_MAX      = 16;               // Maximum number of levels
+                static constexpr float  SILENCE_LEVEL   = 1e-12f;           // Energy of negligible data relative to the whole response (-120 dB)
+
+                typedef struct level_t
+                {
+                    size_t              nRank;          // FFT rank, the FFT size is 2^nRank, the block size is 2^(nRank-1)
+                    size_t              nBlock;         // Block size
+                    size_t              nFirst;         // Index of the first partition, offset is nFirst * nBlock
+                    size_t              nParts;         // Number of partitions
+                    size_t              nActive;        // Number of partitions with non-negligible energy
+                    float              *vParts;         // Spectra of partitions, each of 2^(nRank+1) floats in packed complex format
+                    uint8_t            *vActive;        // Flags of partitions with non-negligible energy, spectra of inactive partitions are undefined
+                } level_t;
+
+                typedef struct image_level_t
+                {
+                    uint32_t            nRank;          // FFT rank
+                    uint32_t            nFirst;         // Index of the first partition
+                    uint32_t            nParts;         // Number of partitions
+                    uint32_t            nActive;        // Number of partitions with non-negligible energy
+                } image_level_t;
+
+                typedef struct image_t
+                {
+                    uint32_t            nLength;        // Length of the impulse response
+                    uint32_t            nLatency;       // Latency
+                    uint32_t            nDelay;         // Pure delay of the input
+                    uint32_t            nOffset;        // Offset of the first partition
+                    uint32_t            nHead;          // Number of samples in the direct head
+                    uint32_t            nLevels;        // Number of levels
+                    uint32_t            nSize;          // Size of the data block in bytes
+                    uint32_t            nPadding;       // Padding, should be zero
+                    image_level_t       vLevels[LEVELS_MAX];
+                } image_t;
+
+                /**
+                 * Owner of the external memory the kernel is attached to, destroyed together with the kernel
+                 */
+                class Storage
+                {
+                    public:
+                        virtual ~Storage();
+                };
+
+            private:
+                friend class IRRegistry;
+
+            private:
+                size_t              nLength;        // Length of the impulse response
+                size_t              nLatency;       // Latency
+                size_t              nDelay;         // Pure delay of the input which replaces the leading silence
+                size_t              nOffset;        // Offset of the first partition, zero if there is direct head
+                size_t              nMaxRank;       // Maximum FFT rank
+                size_t              nHead;          // Number of samples in the direct head
+                float              *vHead;          // Direct head
+                size_t              nLevels;        // Number of levels
+                level_t             vLevels[LEVELS_MAX];
+                size_t              nSize;          // Size of allocated data in bytes
+                uatomic_t           nReady;         // Number of levels with transformed partitions
+                uatomic_t           nRefs;          // Number of references
+                IRRegistry         *pRegistry;      // Registry the kernel is published to, may be NULL
+                IRArena            *pArena;         // Arena of memory blocks, may be NULL
+                uint8_t            *pData;
+                Storage            *pStorage;       // Owner of the external read-only data, may be NULL
+                ipc::Mutex          sPrepare;       // Lock of the thread which prepares levels
+
+            private:
+                class Transformer: public IRBatch
+                {
+                    private:
+                        level_t            *pLevel;
+
+                    public:
+                        explicit Transformer(level_t *l);
+                        virtual ~Transformer() override;
+
+                    public:
+                        virtual void        execute(size_t index, float *tmp) override;
+                };
+
+            private:
+                static void         transform(level_t *l, float *tmp);
+                static void         transform(level_t *l, size_t part, float *tmp);
+
+            public:
+                IRKernel();
+                explicit IRKernel(IRArena *arena);
+                IRKernel(const IRKernel &) = delete;
+                IRKernel(IRKernel &&) = delete;
+                ~IRKernel();
+
+                IRKernel & operator = (const IRKernel &) = delete;
+                IRKernel & operator = (IRKernel &&) = delete;
+
+            public:
+                /**
+                 * Initialize kernel
+                 * @param ir impulse response
+                 * @param length length of the impulse response
+                 * @param rank maximum FFT rank, the maximum partition size is 2^(rank-1)
+                 * @param latency allowed latency in samples, should be zero or power of two
+                 * @return true on success
+                 */
+                bool                init(const float *ir, size_t length, size_t rank, size_t latency);
+
+                /**
+                 * Initialize kernel with the layout computed for the specified length, allows to
+                 * make kernels of impulse responses of different length compatible
+                 * @param ir impulse response
+                 * @param length length of the impulse response
+                 * @param span length used to compute the layout, should not be less than length
+                 * @param rank maximum FFT rank, the maximum partition size is 2^(rank-1)
+                 * @param latency allowed latency in samples, should be zero or power of two
+                 * @return true on success
+                 */
+                bool                init(const float *ir, size_t length, size_t span, size_t rank, size_t latency);
+
+                /**
+                 * Initialize kernel with the layout computed for the specified length and leading silence,
+                 * kernels with the same span, silence and latency are compatible
+                 * @param ir impulse response
+                 * @param length length of the impulse response
+                 * @param span length used to compute the layout, should not be less than length
+                 * @param silence number of leading samples which are not convolved, should not be
+                 *   greater than the value returned by silence() for the impulse response
+                 * @param rank maximum FFT rank, the maximum partition size is 2^(rank-1)
+                 * @param latency allowed latency in samples, should be zero or power of two
+                 * @return true on success
+                 */
+                bool                init(const float *ir, size_t length, size_t span, size_t silence, size_t rank, size_t latency);
+
+                /**
+                 * Initialize kernel and transform only levels which start before the specified offset,
+                 * other levels are transformed by subsequent calls of prepare()
+                 * @param ir impulse response
+                 * @param length length of the impulse response
+                 * @param span length used to compute the layout, should not be less than length
+                 * @param silence number of leading samples which are not convolved
+                 * @param rank maximum FFT rank, the maximum partition size is 2^(rank-1)
+                 * @param latency allowed latency in samples, should be zero or power of two
+                 * @param immediate offset of the impulse response before which levels are transformed immediately
+                 * @return true on success
+                 */
+                bool                init(const float *ir, size_t length, size_t span, size_t silence, size_t rank, size_t latency, size_t immediate);
+
+                /**
+                 * Transform partitions of the next level which is not ready, can be called by the
+                 * background thread while the kernel is used by the convolver
+                 * @param pool pool of threads which transform partitions of the level in parallel, may be NULL
+                 * @return true on success, false if there is no memory
+                 */
+                bool                prepare(IRPool *pool);
+
+                /**
+                 * Export the image of the prepared kernel
+                 * @param image pointer to store the layout descriptor
+                 * @return pointer to the data block of size() bytes, NULL if the kernel is not prepared
+                 */
+                const void         *export_image(image_t *image) const;
+
+                /**
+                 * Initialize kernel with the image exported by another kernel, the data is not copied
+                 * @param image layout descriptor
+                 * @param data data block aligned to DEFAULT_ALIGN, should stay valid while the kernel exists
+                 * @param bytes number of bytes available in the data block
+                 * @param storage owner of the data block, the kernel takes ownership of it on success, may be NULL
+                 * @return true on success, false if the image is not valid
+                 */
+                bool                attach(const image_t *image, const void *data, size_t bytes, Storage *storage);
+
+                /**
+                 * Destroy kernel
+                 */
+                void                destroy();
+
+                /**
+                 * Add the reference to the kernel, the kernel is created with one reference
+                 * @return pointer to the kernel
+                 */
+                IRKernel           *acquire();
+
+                /**
+                 * Release the reference to the kernel, the last reference destroys the kernel
+                 * @param k kernel to release, may be NULL
+                 */
+                static void         release(IRKernel *k);
+
+                /**
+                 * Compute the length of the leading silence of the impulse response
+                 * @param ir impulse response
+                 * @param length length of the impulse response
+                 * @return number of leading samples with negligible energy
+                 */
+                static size_t       silence(const float *ir, size_t length);
+
+            public:
+                inline size_t       length() const          { return nLength;               }
+                inline size_t       latency() const         { return nLatency;              }
+                inline size_t       delay() const           { return nDelay;                }
+                inline size_t       offset() const          { return nOffset;               }
+                inline size_t       max_rank() const        { return nMaxRank;              }
+                inline size_t       head_size() const       { return nHead;                 }
+                inline const float *head() const            { return vHead;                 }
+                inline size_t       levels() const          { return nLevels;               }
+                inline const level_t *level(size_t i) const { return &vLevels[i];           }
+                inline size_t       size() const            { return nSize;                 }
+                inline IRArena     *arena() const           { return pArena;                }
+                inline bool         shared() const          { return pRegistry != NULL;     }
+                inline bool         prepared() const        { return ready() >= nLevels;    }
+
+                /**
+                 * Get the number of levels with transformed partitions, can be called by any thread
+                 * @return number of levels which can be applied by the convolver
+                 */
+                size_t              ready() const;
+
+                /**
+                 * Check that the kernel has the same layout as another kernel
+                 * @param k another kernel
+                 * @return true if kernels have the same layout
+                 */
+                bool                compatible(const IRKernel *k) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_KERNEL_H_ */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_POOL_H_
+#define PRIVATE_PLUGINS_IR_POOL_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+#include <lsp-plug.in/ipc/Thread.h>
+
+#include <private/plugins/ir_signal.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        class IRPool;
+
+        /**
+         * Batch of independent items executed in parallel by threads of the pool. Items are
+         * taken one by one from the shared counter, so threads which complete their items
+         * earlier take the remaining ones. Each pool thread signals the batch when it leaves it,
+         * so the caller sleeps until the items taken by pool threads are executed.
+         */
+        class IRBatch
+        {
+            private:
+                friend class IRPool;
+
+            private:
+                IRBatch            *pNext;          // Next batch in the list of the pool
+                size_t              nCount;         // Number of items
+                volatile uatomic_t  nNext;          // Index of the next item to execute
+                size_t              nRefs;          // Number of pool threads which took the batch, protected by the lock of the pool
+                IRSignal            sDone;          // Signals of pool threads which left the batch
+
+            protected:
+                void                perform(float *tmp);
+
+            public:
+                IRBatch();
+                IRBatch(const IRBatch &) = delete;
+                IRBatch(IRBatch &&) = delete;
+                virtual ~IRBatch();
+
+                IRBatch & operator = (const IRBatch &) = delete;
+                IRBatch & operator = (IRBatch &&) = delete;
+
+            public:
+                /**
+                 * Execute the item of the batch
+                 * @param index index of the item
+                 * @param tmp scratch buffer owned by the calling thread, large enough for any item of the batch
+                 */
+                virtual void        execute(size_t index, float *tmp) = 0;
+
+            public:
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+        /**
+         * Process-wide pool of threads which render files and transform partitions of kernels. The pool is shared
+         * by all instances of the plugin, so simultaneous builds of many instances do not
+         * oversubscribe the CPU. Threads are started by the first bound instance and stopped
+         * when the last instance unbinds.
+         */
+        class IRPool
+        {
+            public:
+                static constexpr size_t THREADS_MAX     = 16;       // Maximum number of threads
+                static constexpr size_t SCRATCH_SIZE    = 0x10000;  // Scratch buffer of each thread, enough for the partition of the maximum rank (floats)
+
+            private:
+                class Worker: public ipc::Thread
+                {
+                    private:
+                        IRPool             *pPool;
+                        float              *vScratch;
+                        uint8_t            *pData;
+
+                    public:
+                        explicit Worker(IRPool *pool);
+                        virtual ~Worker() override;
+
+                    public:
+                        virtual status_t    run() override;
+                        bool                init();
+                };
+
+            private:
+                mutable ipc::Mutex  sLock;
+                IRSignal            sSignal;        // Signals of published batches to idle threads
+                IRBatch            *pBatches;       // List of batches being executed
+                Worker             *vWorkers[THREADS_MAX];
+                size_t              nWorkers;       // Number of running threads
+                size_t              nRefs;          // Number of bound instances
+
+            protected:
+                IRBatch            *acquire();
+                void                shutdown(Worker **list, size_t count);
+
+            public:
+                IRPool();
+                IRPool(const IRPool &) = delete;
+                IRPool(IRPool &&) = delete;
+                ~IRPool();
+
+                IRPool & operator = (const IRPool &) = delete;
+                IRPool & operator = (IRPool &&) = delete;
+
+            public:
+                /**
+                 * Get the pool shared by all instances
+                 * @return pool
+                 */
+                static IRPool      *instance();
+
+            public:
+                /**
+                 * Bind the instance to the pool, starts threads if the pool is not running
+                 */
+                void                bind();
+
+                /**
+                 * Unbind the instance from the pool, stops threads if no more instances are bound
+                 */
+                void                unbind();
+
+                /**
+                 * Execute all items of the batch. The caller executes items too and returns
+                 * after all items have been executed. Should not be called by the real-time thread.
+                 * @param batch batch to execute
+                 * @param count number of items
+                 * @param tmp scratch buffer of the caller, should be large enough for any item of the batch,
+                 *   may be NULL if items do not use it
+                 */
+                void                run(IRBatch *batch, size_t count, float *tmp);
+
+                /**
+                 * Get number of threads of the pool
+                 * @return number of threads, not including the caller
+                 */
+                size_t              threads() const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_POOL_H_ */
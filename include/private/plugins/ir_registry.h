@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_REGISTRY_H_
+#define PRIVATE_PLUGINS_IR_REGISTRY_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+
+#include <private/plugins/ir_kernel.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Process-wide registry of immutable impulse response data shared between
+         * plugin instances. Each entry is reference counted and destroyed when the
+         * last instance releases it. Kernels are published with the key which describes
+         * the source data and all parameters of processing, so instances which render
+         * the same impulse response with the same settings share one kernel.
+         */
+        class IRRegistry
+        {
+            public:
+                typedef struct kernel_key_t
+                {
+                    uint64_t            nHash;          // Hash of the source data and parameters of processing
+                    size_t              nSampleRate;    // Sample rate
+                    size_t              nRank;          // Maximum FFT rank
+                    size_t              nLatency;       // Latency
+                } kernel_key_t;
+
+            private:
+                friend class IRKernel;
+
+                typedef struct kernel_t
+                {
+                    kernel_t           *pNext;          // Next entry in the list
+                    kernel_key_t        sKey;           // Key of the kernel
+                    size_t              nBytes;         // Amount of memory occupied by the kernel
+                    IRKernel           *pKernel;        // Shared kernel
+                } kernel_t;
+
+                typedef struct entry_t
+                {
+                    entry_t            *pNext;          // Next entry in the list
+                    char               *sPath;          // Path to the file
+                    uint64_t            nHash;          // Content hash of the file
+                    size_t              nSampleRate;    // Sample rate of the data, zero for decoded file
+                    size_t              nRefs;          // Number of references
+                    size_t              nBytes;         // Amount of memory occupied by data
+                    dspu::Sample       *pSample;        // Shared sample
+                } entry_t;
+
+            private:
+                mutable ipc::Mutex  sLock;
+                entry_t            *pEntries;
+                kernel_t           *pKernels;
+                volatile uatomic_t  nBytes;         // Modified under the lock, can be read without it
+
+            protected:
+                entry_t            *find(const char *path, uint64_t hash, size_t sample_rate);
+                static void         destroy_sample(dspu::Sample *s);
+                static void         destroy_entry(entry_t *e);
+                kernel_t           *find_kernel(const kernel_key_t *key);
+                void                release_kernel(IRKernel *k);
+
+            public:
+                IRRegistry();
+                IRRegistry(const IRRegistry &) = delete;
+                IRRegistry(IRRegistry &&) = delete;
+                ~IRRegistry();
+
+                IRRegistry & operator = (const IRRegistry &) = delete;
+                IRRegistry & operator = (IRRegistry &&) = delete;
+
+            public:
+                /**
+                 * Get the process-wide instance of the registry
+                 * @return process-wide instance of the registry
+                 */
+                static IRRegistry  *instance();
+
+            public:
+                /**
+                 * Acquire shared sample
+                 * @param path path to the file
+                 * @param hash content hash of the file
+                 * @param sample_rate sample rate of the data, zero for decoded file
+                 * @return pointer to the shared sample or NULL if there is no such sample,
+                 *   should be released by the release() call
+                 */
+                dspu::Sample       *acquire(const char *path, uint64_t hash, size_t sample_rate);
+
+                /**
+                 * Publish sample and acquire it
+                 * @param path path to the file
+                 * @param hash content hash of the file
+                 * @param sample_rate sample rate of the data, zero for decoded file
+                 * @param s sample to publish, the registry takes ownership of it; if the sample with
+                 *   the same key has already been published or on error, the passed sample is destroyed
+                 * @return pointer to the shared sample or NULL on error,
+                 *   should be released by the release() call
+                 */
+                dspu::Sample       *publish(const char *path, uint64_t hash, size_t sample_rate, dspu::Sample *s);
+
+                /**
+                 * Release shared sample
+                 * @param s shared sample to release
+                 */
+                void                release(dspu::Sample *s);
+
+                /**
+                 * Acquire shared kernel, the kernel may be not prepared yet
+                 * @param key key of the kernel
+                 * @return pointer to the shared kernel or NULL if there is no such kernel,
+                 *   should be released by the IRKernel::release() call
+                 */
+                IRKernel           *acquire_kernel(const kernel_key_t *key);
+
+                /**
+                 * Publish kernel and keep the reference of the caller to it
+                 * @param key key of the kernel
+                 * @param k kernel with the single reference, should not be allocated in the arena of the instance;
+                 *   if the kernel with the same key has already been published, the passed kernel is released
+                 * @return pointer to the shared kernel, or the passed kernel if it can not be published,
+                 *   should be released by the IRKernel::release() call
+                 */
+                IRKernel           *publish_kernel(const kernel_key_t *key, IRKernel *k);
+
+                /**
+                 * Get the total amount of memory occupied by shared data, does not lock
+                 * @return total amount of memory occupied by shared data in bytes
+                 */
+                size_t              resident_bytes() const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_REGISTRY_H_ */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_RESAMPLER_H_
+#define PRIVATE_PLUGINS_IR_RESAMPLER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Streaming resampler by the integer factor for the multi-rate convolution.
+         * Uses the linear-phase windowed-sinc low-pass filter which introduces delay()
+         * samples of the high sample rate in each direction. The instance should be used
+         * either for downsampling or for upsampling of one channel.
+         */
+        class IRResampler
+        {
+            public:
+                static constexpr size_t FACTOR_MAX      = 4;        // Maximum resampling factor
+                static constexpr size_t BLOCK_SIZE      = 1024;     // Maximum number of samples of the high sample rate processed at once
+
+            private:
+                size_t              nFactor;        // Resampling factor
+                size_t              nTaps;          // Number of taps of the filter
+                size_t              nPoly;          // Number of taps of each polyphase component
+                size_t              nPhase;         // Phase of the current sample of the high sample rate
+                float              *vFilter;        // Low-pass filter with unit gain
+                float              *vPoly;          // Reversed polyphase components of the interpolation filter
+                float              *vBuffer;        // History buffer
+                uint8_t            *pData;
+
+            public:
+                IRResampler();
+                IRResampler(const IRResampler &) = delete;
+                IRResampler(IRResampler &&) = delete;
+                ~IRResampler();
+
+                IRResampler & operator = (const IRResampler &) = delete;
+                IRResampler & operator = (IRResampler &&) = delete;
+
+            public:
+                /**
+                 * Initialize resampler
+                 * @param factor resampling factor, from 2 to FACTOR_MAX
+                 * @return true on success
+                 */
+                bool                init(size_t factor);
+
+                /**
+                 * Destroy resampler
+                 */
+                void                destroy();
+
+                /**
+                 * Clear the history of the resampler
+                 */
+                void                clear();
+
+                /**
+                 * Downsample the signal
+                 * @param dst destination buffer to store at least count / factor + 1 samples of the low sample rate
+                 * @param src source buffer of the high sample rate
+                 * @param count number of samples to process, should not be greater than BLOCK_SIZE
+                 * @return number of samples stored to the destination buffer
+                 */
+                size_t              downsample(float *dst, const float *src, size_t count);
+
+                /**
+                 * Upsample the signal and add it to the destination buffer
+                 * @param dst destination buffer of the high sample rate
+                 * @param src source buffer with samples of the low sample rate produced by downsample()
+                 *   for the same number of samples of the high sample rate
+                 * @param count number of samples of the high sample rate, should not be greater than BLOCK_SIZE
+                 */
+                void                upsample(float *dst, const float *src, size_t count);
+
+            public:
+                inline size_t       factor() const          { return nFactor;               }
+                inline size_t       delay() const           { return delay(nFactor);        }
+
+                /**
+                 * Get number of taps of the filter
+                 * @param factor resampling factor
+                 * @return number of taps
+                 */
+                static size_t       taps(size_t factor);
+
+                /**
+                 * Get delay introduced by the filter in each direction
+                 * @param factor resampling factor
+                 * @return delay in samples of the high sample rate
+                 */
+                static size_t       delay(size_t factor);
+
+                /**
+                 * Get the length of the decimated impulse response
+                 * @param length length of the impulse response
+                 * @param factor resampling factor
+                 * @return length of the decimated impulse response
+                 */
+                static size_t       decimated_length(size_t length, size_t factor);
+
+                /**
+                 * Band-limit and decimate the impulse response without the phase shift, the
+                 * result is scaled by the factor, so the convolution at the low sample rate
+                 * keeps the gain of the original response
+                 * @param dst destination buffer of decimated_length() samples
+                 * @param src impulse response
+                 * @param length length of the impulse response
+                 * @param factor resampling factor
+                 */
+                static void         decimate(float *dst, const float *src, size_t length, size_t factor);
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_RESAMPLER_H_ */
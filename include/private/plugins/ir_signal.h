@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_SIGNAL_H_
+#define PRIVATE_PLUGINS_IR_SIGNAL_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/Condition.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Counting semaphore which puts idle threads to sleep until there is work for them.
+         * Each received signal is consumed by exactly one waiting thread.
+         */
+        class IRSignal
+        {
+            private:
+                ipc::Condition          sCond;
+                size_t                  nCount;         // Number of signals, protected by the lock of the condition
+
+            public:
+                IRSignal();
+                IRSignal(const IRSignal &) = delete;
+                IRSignal(IRSignal &&) = delete;
+                ~IRSignal();
+
+                IRSignal & operator = (const IRSignal &) = delete;
+                IRSignal & operator = (IRSignal &&) = delete;
+
+            public:
+                /**
+                 * Post signals and wake up waiting threads. The caller does not touch the
+                 * object after the signal has been consumed, so the waiting thread may destroy it.
+                 * @param count number of signals
+                 */
+                void                    post(size_t count = 1);
+
+                /**
+                 * Wait for the signal and consume it, the wait may end earlier than the timeout expires
+                 * @param millis maximum time to wait in milliseconds
+                 * @return true if the signal has been consumed, false otherwise
+                 */
+                bool                    wait(size_t millis);
+
+                void                    dump(dspu::IStateDumper *v) const;
+        };
+
+        /**
+         * Counting semaphore based on the native semaphore of the system. The post does not take
+         * any locks, so it can be called by the real-time thread.
+         */
+        class IRSemaphore
+        {
+            private:
+                void                   *hHandle;        // Native semaphore
+
+            public:
+                IRSemaphore();
+                IRSemaphore(const IRSemaphore &) = delete;
+                IRSemaphore(IRSemaphore &&) = delete;
+                ~IRSemaphore();
+
+                IRSemaphore & operator = (const IRSemaphore &) = delete;
+                IRSemaphore & operator = (IRSemaphore &&) = delete;
+
+            public:
+                /**
+                 * Create the native semaphore
+                 * @return true on success
+                 */
+                bool                    init();
+
+                /**
+                 * Destroy the native semaphore, no threads should wait for it
+                 */
+                void                    destroy();
+
+                /**
+                 * Post the signal without blocking
+                 */
+                void                    post();
+
+                /**
+                 * Wait for the signal and consume it
+                 */
+                void                    wait();
+
+                void                    dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_SIGNAL_H_ */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_IR_WORKER_H_
+#define PRIVATE_PLUGINS_IR_WORKER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/Thread.h>
+
+#include <private/plugins/ir_signal.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        class IRWorker;
+
+        /**
+         * Job with a deadline. The job is submitted by the real-time thread and should be
+         * completed by the worker thread until the deadline. If the worker did not manage
+         * to start the job until the deadline, the job is executed by the real-time thread.
+         * The real-time thread never waits for the job executed by the worker.
+         */
+        class IRJob
+        {
+            private:
+                friend class IRWorker;
+
+            public:
+                enum job_state_t
+                {
+                    JS_IDLE,                        // Job has not been submitted
+                    JS_PENDING,                     // Job has been submitted and waits for execution
+                    JS_RUNNING,                     // Job is currently executing
+                    JS_DONE                         // Job has been completed
+                };
+
+                enum job_deadline_t
+                {
+                    JD_DONE,                        // Job has been completed by the worker or has not been submitted
+                    JD_MISSED,                      // Job has been executed by the caller
+                    JD_BUSY                         // Job is still executed by the worker
+                };
+
+            private:
+                volatile uatomic_t  nState;         // State of the job
+                volatile uatomic_t  nQueued;        // Number of references to the job from the queue of the worker
+
+            public:
+                IRJob();
+                IRJob(const IRJob &) = delete;
+                IRJob(IRJob &&) = delete;
+                virtual ~IRJob();
+
+                IRJob & operator = (const IRJob &) = delete;
+                IRJob & operator = (IRJob &&) = delete;
+
+            public:
+                /**
+                 * Execute the job
+                 */
+                virtual void        execute() = 0;
+
+            public:
+                /**
+                 * Execute the job in the caller's thread if it is still pending
+                 * @return true if the job has been executed by the caller
+                 */
+                bool                run();
+
+                /**
+                 * Reach the deadline without blocking: execute the job in the caller's thread if
+                 * the worker did not start it. Should be called by the real-time thread only.
+                 * @return JD_DONE if the job is complete, JD_MISSED if the job has been executed
+                 *   by the caller, JD_BUSY if the worker is still executing the job
+                 */
+                job_deadline_t      complete();
+
+                /**
+                 * Cancel the job if the worker did not start it, does not block
+                 * @return true if the job is not executed by the worker
+                 */
+                bool                cancel();
+
+                /**
+                 * Cancel pending job and wait until the worker releases it, should not be called
+                 * by the real-time thread
+                 */
+                void                sync();
+
+                inline uatomic_t    state() const       { return nState;                }
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+        /**
+         * Worker thread which executes jobs submitted by the real-time thread. Jobs are passed
+         * via the lock-free single producer, single consumer queue, the idle worker sleeps
+         * until the job is submitted.
+         */
+        class IRWorker: public ipc::Thread
+        {
+            private:
+                static constexpr size_t QUEUE_SIZE  = 64;
+
+            private:
+                IRJob              *vQueue[QUEUE_SIZE];
+                volatile uatomic_t  nHead;          // Read position, modified by the worker only
+                volatile uatomic_t  nTail;          // Write position, modified by the producer only
+                volatile uatomic_t  nSleep;         // The worker is going to sleep and should be woken up
+                IRSemaphore         sWakeup;        // Wakes up the worker when jobs are submitted
+                bool                bActive;        // Worker thread is active
+
+            protected:
+                IRJob              *pop();
+
+            public:
+                IRWorker();
+                IRWorker(const IRWorker &) = delete;
+                IRWorker(IRWorker &&) = delete;
+                virtual ~IRWorker() override;
+
+                IRWorker & operator = (const IRWorker &) = delete;
+                IRWorker & operator = (IRWorker &&) = delete;
+
+            public:
+                virtual status_t    run() override;
+
+            public:
+                /**
+                 * Start the worker thread
+                 * @return status of operation
+                 */
+                status_t            launch();
+
+                /**
+                 * Stop the worker thread and release all queued jobs
+                 */
+                void                shutdown();
+
+                /**
+                 * Submit the job, should be called by the real-time thread only
+                 * @param job job to submit
+                 * @return true if job has been submitted, false if the queue is full and
+                 *   the caller should execute the job itself
+                 */
+                bool                submit(IRJob *job);
+
+                inline bool         active() const      { return bActive;               }
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_IR_WORKER_H_ */
@@ -27,7 +27,7 @@
 
 #define LSP_PLUGINS_IMPULSE_RESPONSES_VERSION_MAJOR       1
 #define LSP_PLUGINS_IMPULSE_RESPONSES_VERSION_MINOR       0
-#define LSP_PLUGINS_IMPULSE_RESPONSES_VERSION_MICRO       33
+#define LSP_PLUGINS_IMPULSE_RESPONSES_VERSION_MICRO       34
 
 #define LSP_PLUGINS_IMPULSE_RESPONSES_VERSION  \
     LSP_MODULE_VERSION( \
@@ -73,6 +73,65 @@ namespace lsp
             { NULL, NULL }
         };
 
+        static const port_item_t ir_latency[] =
+        {
+            { "0",              NULL },
+            { "64",             NULL },
+            { "128",            NULL },
+            { "256",            NULL },
+            { "512",            NULL },
+            { "1024",           NULL },
+            { "2048",           NULL },
+            { "4096",           NULL },
+            { "8192",           NULL },
+            { NULL, NULL }
+        };
+
+        static const port_item_t ir_tail_factor[] =
+        {
+            { "1/2",            NULL },
+            { "1/4",            NULL },
+            { NULL, NULL }
+        };
+
+        static const port_item_t ir_bank_slot[] =
+        {
+            { "Live",           NULL },
+            { "1",              NULL },
+            { "2",              NULL },
+            { "3",              NULL },
+            { "4",              NULL },
+            { "5",              NULL },
+            { "6",              NULL },
+            { "7",              NULL },
+            { "8",              NULL },
+            { NULL, NULL }
+        };
+
+        static const port_item_t ir_bank_target[] =
+        {
+            { "1",              NULL },
+            { "2",              NULL },
+            { "3",              NULL },
+            { "4",              NULL },
+            { "5",              NULL },
+            { "6",              NULL },
+            { "7",              NULL },
+            { "8",              NULL },
+            { NULL, NULL }
+        };
+
+        static const port_item_t ir_bank_limit[] =
+        {
+            { "64 MB",          NULL },
+            { "128 MB",         NULL },
+            { "256 MB",         NULL },
+            { "512 MB",         NULL },
+            { "1 GB",           NULL },
+            { "2 GB",           NULL },
+            { NULL, NULL }
+        };
+
         static const port_item_t ir_file_select[] =
         {
             { "File 1",         "file.f1" },
@@ -92,10 +151,32 @@ namespace lsp
         #define IR_COMMON \
             BYPASS, \
             COMBO("fft", "FFT size", "FFT size", impulse_responses_metadata::FFT_RANK_DEFAULT, ir_fft_rank), \
+            COMBO("lat", "Latency budget", "Latency", impulse_responses_metadata::LATENCY_DEFAULT, ir_latency), \
             DRY_GAIN(1.0f), \
             WET_GAIN(1.0f), \
             DRYWET(100.0f), \
-            OUT_GAIN
+            OUT_GAIN, \
+            SWITCH("dcache", "Disk cache", "Disk cache", 0.0f), \
+            METER("rch", "Resample cache hit rate", U_PERCENT, impulse_responses_metadata::CACHE_HITS), \
+            SWITCH("mrt", "Multi-rate tail", "Multi-rate", 0.0f), \
+            CONTROL("mrx", "Multi-rate tail crossover", "MR split", U_MSEC, impulse_responses_metadata::TAIL_SPLIT), \
+            COMBO("mrf", "Multi-rate tail sample rate", "MR rate", impulse_responses_metadata::TAIL_FACTOR_DEFAULT, ir_tail_factor), \
+            METER("mrs", "Multi-rate tail CPU saving", U_PERCENT, impulse_responses_metadata::TAIL_SAVING), \
+            SWITCH("hyb", "Hybrid tail synthesis", "Hybrid", 0.0f), \
+            CONTROL("hyx", "Hybrid tail crossover", "Hyb split", U_MSEC, impulse_responses_metadata::HYBRID_SPLIT), \
+            METER("hye", "Hybrid tail spectral error", U_DB, impulse_responses_metadata::HYBRID_ERROR), \
+            CONTROL("xft", "Impulse response swap crossfade", "Swap fade", U_MSEC, impulse_responses_metadata::XFADE), \
+            METER("xfl", "Impulse response swap load", U_PERCENT, impulse_responses_metadata::SWAP_LOAD), \
+            METER("rjd", "Reconfiguration jobs completed", U_NONE, impulse_responses_metadata::JOBS), \
+            METER("rjc", "Reconfiguration jobs cancelled", U_NONE, impulse_responses_metadata::JOBS), \
+            COMBO("bks", "Bank slot", "Slot", 0, ir_bank_slot), \
+            COMBO("bkt", "Bank target slot", "Target", 0, ir_bank_target), \
+            TRIGGER("bkw", "Bank slot store", "Store"), \
+            TRIGGER("bkc", "Bank slot clear", "Clear"), \
+            COMBO("bkl", "Bank memory limit", "Bank limit", impulse_responses_metadata::BANK_LIMIT_DEFAULT, ir_bank_limit), \
+            STATUS("bkr", "Bank store status"), \
+            METER("bku", "Bank memory usage", U_PERCENT, impulse_responses_metadata::BANK_USAGE), \
+            METER("shm", "Shared impulse response memory", U_MBYTES, impulse_responses_metadata::SHARED_MEMORY)
 
         #define IR_SAMPLE_FILE(id, label)   \
             PATH("ifn" id, "Impulse file" label),    \
@@ -107,14 +188,19 @@ namespace lsp
             TRIGGER("ils" id, "Impulse preview listen" label, "Play" label), \
             TRIGGER("ilc" id, "Impulse preview stop" label, "Stop" label), \
             SWITCH("irv" id, "Impulse reverse" label, "Reverse" label, 0.0f), \
+            SWITCH("ate" id, "Auto trim" label, "Auto trim" label, 0.0f), \
+            CONTROL("atl" id, "Auto trim level" label, NULL, U_DB, impulse_responses_metadata::TRIM_LEVEL), \
             STATUS("ifs" id, "Load status" label), \
             METER("ifl" id, "Impulse length" label, U_MSEC, impulse_responses_metadata::CONV_LENGTH), \
+            METER("itl" id, "Trimmed length" label, U_MSEC, impulse_responses_metadata::CONV_LENGTH), \
+            METER("irt" id, "Estimated RT60" label, U_MSEC, impulse_responses_metadata::CONV_LENGTH), \
             MESH("ifd" id, "Impulse file contents" label, impulse_responses_metadata::TRACKS_MAX, impulse_responses_metadata::MESH_SIZE)
 
         #define IR_SOURCE(id, label, alias, select, dfl) \
             COMBO("cs" id, "Channel source" label, "Source" alias, dfl, select), \
             AMP_GAIN100("mk" id, "Makeup gain" label, "Makeup" alias, 1.0f), \
             BLINK("ca" id, "Channel activity" label), \
+            BLINK("csl" id, "Channel sleeping" label), \
             CONTROL("pd" id, "Pre-delay" label, "Pre-delay" alias, U_MSEC, impulse_responses_metadata::PREDELAY)
 
         #define IR_EQ_BAND(id, freq)    \
@@ -122,6 +208,7 @@ namespace lsp
 
         #define IR_EQUALIZER    \
             SWITCH("wpp", "Wet post-process", "Wet postproc", 0),    \
+            SWITCH("wpb", "Wet post-process baking", "Bake postproc", 0),    \
             SWITCH("eqv", "Equalizer visibility", "Show Eq", 0),    \
             COMBO("lcm", "Low-cut mode", "LC mode", 0, filter_slope),      \
             LOG_CONTROL("lcf", "Low-cut frequency", "LC freq", U_HZ, impulse_responses_metadata::LCF),   \
@@ -156,6 +243,9 @@ namespace lsp
             PORTS_STEREO_PLUGIN,
             IR_COMMON,
             COMBO("fsel", "File selector", "File selector", 0, ir_file_select), \
+            SWITCH("tst", "True stereo", "True stereo", 0.0f), \
+            SWITCH("mph", "Impulse file morph", "Morph", 0.0f), \
+            CONTROL("mpv", "Impulse file morph amount", "Morph amount", U_PERCENT, impulse_responses_metadata::MORPH), \
 
             // Input controls
             IR_SAMPLE_FILE("0", " 1"),
@@ -167,6 +257,43 @@ namespace lsp
             PORTS_END
         };
 
+        static const port_t impulse_responses_mono_stereo_ports[] =
+        {
+            // Input audio ports
+            AUDIO_INPUT_MONO,
+            AUDIO_OUTPUT_LEFT,
+            AUDIO_OUTPUT_RIGHT,
+            IR_COMMON,
+
+            // Input controls
+            IR_SAMPLE_FILE("", ""),
+            IR_SOURCE("_l", " Left", " L", ir_source_mono, 1),
+            IR_SOURCE("_r", " Right", " R", ir_source_mono, 2),
+            IR_EQUALIZER,
+
+            PORTS_END
+        };
+
+        static const port_group_item_t mono_stereo_in_group_ports[] =
+        {
+            { "in",         PGR_CENTER      },
+            { NULL }
+        };
+
+        static const port_group_item_t mono_stereo_out_group_ports[] =
+        {
+            { "out_l",      PGR_LEFT        },
+            { "out_r",      PGR_RIGHT       },
+            { NULL }
+        };
+
+        static const port_group_t mono_stereo_plugin_port_groups[] =
+        {
+            { "mono_in",    "Mono Input",       GRP_MONO,       PGF_IN | PGF_MAIN,      mono_stereo_in_group_ports      },
+            { "stereo_out", "Stereo Output",    GRP_STEREO,     PGF_OUT | PGF_MAIN,     mono_stereo_out_group_ports     },
+            PORT_GROUPS_END
+        };
+
         static const int plugin_classes[]           = { C_REVERB, -1 };
         static const int clap_features_mono[]       = { CF_AUDIO_EFFECT, CF_REVERB, CF_MONO, -1 };
         static const int clap_features_stereo[]     = { CF_AUDIO_EFFECT, CF_REVERB, CF_STEREO, -1 };
@@ -239,5 +366,35 @@ namespace lsp
             stereo_plugin_port_groups,
             &impulse_responses_bundle
         };
+
+        const meta::plugin_t  impulse_responses_mono_stereo =
+        {
+            "Impulsantworten Mono/Stereo",
+            "Impulse Responses Mono/Stereo",
+            "Impulse Responses Mono/Stereo",
+            "IA1MS",
+            &developers::v_sadovnikov,
+            "impulse_responses_mono_stereo",
+            {
+                LSP_LV2_URI("impulse_responses_mono_stereo"),
+                LSP_LV2UI_URI("impulse_responses_mono_stereo"),
+                "ia1x",
+                LSP_VST3_UID("ia1ms   ia1x"),
+                LSP_VST3UI_UID("ia1ms   ia1x"),
+                0,
+                NULL,
+                LSP_CLAP_URI("impulse_responses_mono_stereo"),
+                LSP_GST_UID("impulse_responses_mono_stereo"),
+            },
+            LSP_PLUGINS_IMPULSE_RESPONSES_VERSION,
+            plugin_classes,
+            clap_features_stereo,
+            E_DUMP_STATE | E_FILE_PREVIEW,
+            impulse_responses_mono_stereo_ports,
+            "convolution/impulse_responses/mono_stereo.xml",
+            NULL,
+            mono_stereo_plugin_port_groups,
+            &impulse_responses_bundle
+        };
     } // namespace meta
 } // namespace lsp
@@ -35,14 +35,29 @@ namespace lsp
     namespace plugins
     {
         static constexpr size_t TMP_BUF_SIZE        = 0x1000;
+        static constexpr size_t HISTORY_SIZE        = 0x10000;      // Size of the input history to prime the new convolver, power of two, 256 KB per channel
+        static constexpr size_t PRIME_MAX           = HISTORY_SIZE - TMP_BUF_SIZE;  // Maximum number of samples to prime the new convolver
+        static constexpr size_t WET_SIZE            = 0x10000;      // Size of the delay line of the wet signal, power of two
+        static constexpr size_t PREDELAY_LIMIT      = WET_SIZE - TMP_BUF_SIZE;      // Maximum delay of the wet signal (samples)
         static constexpr size_t CONV_RANK           = 10;
+        static constexpr size_t RS_CACHE_BYTES      = 0x4000000;    // Memory cap of the resample cache for each file
+        static constexpr float  SILENCE_THRESH      = 1e-6f;        // Level of silence for the convolver, -120 dB
+        static constexpr float  PREPARE_SPAN        = 50.0f;        // Part of the response transformed before the convolver goes live (ms)
+        static constexpr float  PREVIEW_LENGTH      = 500.0f;       // Length of the impulse response rendered by the preview (ms)
+        static constexpr float  PREVIEW_SETTLE      = 250.0f;       // Time the settings should be stable to start the full render (ms)
+        static constexpr float  BYPASS_FADE         = 5.0f;         // Bypass switch time, ms
+        static constexpr float  EQ_BAKE_TAIL        = 500.0f;       // Maximum length of the tail added by the baked equalizer, ms
+        static constexpr float  EQ_BAKE_THRESH      = 1e-6f;        // Relative level of the tail of baked equalizer to be cut, -120 dB
+        static constexpr float  HYBRID_FADE         = 10.0f;        // Crossfade between the early part and the synthesized tail, ms
+        static constexpr float  SWAP_FADE_MAX       = 5000.0f;      // Maximum crossfade when the new convolver is longer than the primed history, ms
 
         //---------------------------------------------------------------------
         // Plugin factory
         static const meta::plugin_t *plugins[] =
         {
             &meta::impulse_responses_mono,
-            &meta::impulse_responses_stereo
+            &meta::impulse_responses_stereo,
+            &meta::impulse_responses_mono_stereo
         };
 
         static plug::Module *plugin_factory(const meta::plugin_t *meta)
@@ -50,7 +65,7 @@ namespace lsp
             return new impulse_responses(meta);
         }
 
-        static plug::Factory factory(plugin_factory, plugins, 2);
+        static plug::Factory factory(plugin_factory, plugins, 3);
 
         //-------------------------------------------------------------------------
         static float band_freqs[] =
@@ -117,6 +132,105 @@ namespace lsp
             v->write("pCore", pCore);
         }
 
+        //-------------------------------------------------------------------------
+        impulse_responses::IRPreparer::IRPreparer(impulse_responses *base)
+        {
+            pCore       = base;
+        }
+
+        impulse_responses::IRPreparer::~IRPreparer()
+        {
+            pCore       = NULL;
+        }
+
+        status_t impulse_responses::IRPreparer::run()
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            return pCore->prepare_convolvers();
+        }
+
+        void impulse_responses::IRPreparer::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pCore", pCore);
+        }
+
+        //-------------------------------------------------------------------------
+        impulse_responses::FileRenderer::FileRenderer(impulse_responses *base)
+        {
+            pCore       = base;
+            nStatus     = STATUS_OK;
+        }
+
+        impulse_responses::FileRenderer::~FileRenderer()
+        {
+            pCore       = NULL;
+        }
+
+        void impulse_responses::FileRenderer::execute(size_t index, float *tmp)
+        {
+            // Other files are not rendered after the first error
+            if (status() != STATUS_OK)
+                return;
+
+            status_t res = pCore->render_file(&pCore->vFiles[index]);
+            if (res != STATUS_OK)
+                atomic_cas(&nStatus, uatomic_t(STATUS_OK), uatomic_t(res));
+        }
+
+        status_t impulse_responses::FileRenderer::status() const
+        {
+            return status_t(atomic_load(const_cast<uatomic_t *>(&nStatus)));
+        }
+
+        void impulse_responses::FileRenderer::dump(dspu::IStateDumper *v) const
+        {
+            IRBatch::dump(v);
+            v->write("pCore", pCore);
+            v->write("nStatus", nStatus);
+        }
+
+        //-------------------------------------------------------------------------
+        impulse_responses::ChannelBuilder::ChannelBuilder(impulse_responses *base, uint32_t phase, uint32_t step)
+        {
+            pCore       = base;
+            nPhase      = phase;
+            nStep       = step;
+            nStatus     = STATUS_OK;
+        }
+
+        impulse_responses::ChannelBuilder::~ChannelBuilder()
+        {
+            pCore       = NULL;
+        }
+
+        void impulse_responses::ChannelBuilder::execute(size_t index, float *tmp)
+        {
+            // Each channel commits its own convolver, other channels are not built after the first error
+            if (status() != STATUS_OK)
+                return;
+
+            status_t res = pCore->build_channel(index, nPhase, nStep);
+            if (res != STATUS_OK)
+                atomic_cas(&nStatus, uatomic_t(STATUS_OK), uatomic_t(res));
+        }
+
+        status_t impulse_responses::ChannelBuilder::status() const
+        {
+            return status_t(atomic_load(const_cast<uatomic_t *>(&nStatus)));
+        }
+
+        void impulse_responses::ChannelBuilder::dump(dspu::IStateDumper *v) const
+        {
+            IRBatch::dump(v);
+            v->write("pCore", pCore);
+            v->write("nPhase", nPhase);
+            v->write("nStep", nStep);
+            v->write("nStatus", nStatus);
+        }
+
         //-------------------------------------------------------------------------
         impulse_responses::GCTask::GCTask(impulse_responses *base)
         {
@@ -143,28 +257,125 @@ namespace lsp
         impulse_responses::impulse_responses(const meta::plugin_t *metadata):
             plug::Module(metadata),
             sConfigurator(this),
+            sPreparer(this),
             sGCTask(this)
         {
+            pRegistry       = IRRegistry::instance();
+            pPool           = NULL;
+
             nChannels       = 0;
+            nInputs         = 0;
             for (const meta::port_t *p = metadata->ports; p->id != NULL; ++p)
-                if ((meta::is_out_port(p)) && (meta::is_audio_port(p)))
+            {
+                if (!meta::is_audio_port(p))
+                    continue;
+                if (meta::is_out_port(p))
                     ++nChannels;
+                else
+                    ++nInputs;
+            }
+            nFiles          = nInputs;
 
             vChannels       = NULL;
             vFiles          = NULL;
             pExecutor       = NULL;
             nReconfigReq    = 0;
             nReconfigResp   = -1;
+            nCancel         = 0;
+            nJobFiles       = 0;
+            sJob.nRank          = 0;
+            sJob.nLatency       = 0;
+            sJob.nTailFactor    = 0;
+            sJob.fTailSplit     = meta::impulse_responses_metadata::TAIL_SPLIT_DFL;
+            sJob.fHybridSplit   = meta::impulse_responses_metadata::HYBRID_SPLIT_DFL;
+            sJob.bHybrid        = false;
+            sJob.bTrueStereo    = false;
+            sJob.bMatrix        = false;
+            sJob.bMorph         = false;
+            sJob.bDiskCache     = false;
+            nJobsDone       = 0;
+            nJobsCancelled  = 0;
+            nSettleReq      = 0;
+            nSettle         = 0;
+            bPreview        = false;
+            bRefine         = false;
             fGain           = 1.0f;
             nRank           = 0;
+            nLatency        = 0;
+            nDelay          = 0;
+            nImmediate      = 0;
+            bTrueStereo     = false;
+            bDiskCache      = false;
+            for (size_t i=0; i<KC_QUEUE_SIZE; ++i)
+                vKCQueue[i].pKernel = NULL;
+            nKCQueue        = 0;
+            nTailFactor     = 0;
+            fTailSplit      = meta::impulse_responses_metadata::TAIL_SPLIT_DFL;
+            bHybrid         = false;
+            fHybridSplit    = meta::impulse_responses_metadata::HYBRID_SPLIT_DFL;
+            nXFade          = 0;
+            nHistPos        = 0;
+            nWetPos         = 0;
+            nHistFill       = 0;
+            bMorph          = false;
+            fMorph          = 0.0f;
+            for (size_t i=0; i<meta::impulse_responses_metadata::BANK_SLOTS; ++i)
+            {
+                bank_slot_t *b      = &vBank[i];
+                for (size_t j=0; j<IRConvolver::CHANNELS_MAX; ++j)
+                {
+                    b->vConv[j]         = NULL;
+                    b->vEqBaked[j]      = false;
+                }
+                b->nLatency         = 0;
+                b->nSampleRate      = 0;
+                b->nSize            = 0;
+                b->bUsed            = false;
+            }
+            nSlot           = 0;
+            nSlotReq        = 0;
+            nBankTarget     = 1;
+            nStoreReq       = 0;
+            nStoreSlot      = 0;
+            nClearReq       = 0;
+            nBankLimit      = 0;
+            nBankStatus     = STATUS_UNSPECIFIED;
+            nCacheClock     = 0;
+            nCacheHits      = 0;
+            nCacheMisses    = 0;
             pGCList         = NULL;
 
             pBypass         = NULL;
             pRank           = NULL;
+            pLatency        = NULL;
             pDry            = NULL;
             pWet            = NULL;
             pDryWet         = NULL;
             pOutGain        = NULL;
+            pDiskCache      = NULL;
+            pCacheHits      = NULL;
+            pTrueStereo     = NULL;
+            pMorph          = NULL;
+            pMorphAmount    = NULL;
+            pTailOn         = NULL;
+            pTailSplit      = NULL;
+            pTailFactor     = NULL;
+            pTailSaving     = NULL;
+            pHybrid         = NULL;
+            pHybridSplit    = NULL;
+            pHybridError    = NULL;
+            pXFade          = NULL;
+            pSwapLoad       = NULL;
+            pJobsDone       = NULL;
+            pJobsCancelled  = NULL;
+            pBankSlot       = NULL;
+            pBankTarget     = NULL;
+            pBankStore      = NULL;
+            pBankClear      = NULL;
+            pBankLimit      = NULL;
+            pBankStatus     = NULL;
+            pBankUsage      = NULL;
+            pSharedMemory   = NULL;
 
             pData           = NULL;
         }
@@ -184,7 +395,7 @@ namespace lsp
             s   = NULL;
         }
 
-        void impulse_responses::destroy_convolver(dspu::Convolver * &c)
+        void impulse_responses::destroy_convolver(IRConvolver * &c)
         {
             if (c == NULL)
                 return;
@@ -194,6 +405,21 @@ namespace lsp
             c   = NULL;
         }
 
+        void impulse_responses::destroy_kernel(IRKernel * &k)
+        {
+            IRKernel::release(k);
+            k   = NULL;
+        }
+
+        void impulse_responses::destroy_synth(IRFdn * &s)
+        {
+            if (s == NULL)
+                return;
+            s->destroy();
+            delete s;
+            s   = NULL;
+        }
+
         void impulse_responses::destroy_samples(dspu::Sample *gc_list)
         {
             // Iterate over the list and destroy each sample in the list
@@ -205,11 +431,54 @@ namespace lsp
             }
         }
 
+        void impulse_responses::recycle_sample(dspu::Sample * &s)
+        {
+            if (s == NULL)
+                return;
+            sArena.release_sample(s);
+            s   = NULL;
+        }
+
+        void impulse_responses::recycle_samples(dspu::Sample *gc_list)
+        {
+            // Keep released samples for the next reconfiguration
+            while (gc_list != NULL)
+            {
+                dspu::Sample *next = gc_list->gc_next();
+                recycle_sample(gc_list);
+                gc_list = next;
+            }
+        }
+
+        void impulse_responses::release_shared(dspu::Sample * &s)
+        {
+            if (s == NULL)
+                return;
+            pRegistry->release(s);
+            s   = NULL;
+        }
+
+        void impulse_responses::drop_cache(af_descriptor_t *af)
+        {
+            for (size_t i=0; i<RS_CACHE_SIZE; ++i)
+            {
+                rs_cache_t *rc      = &af->vCache[i];
+                release_shared(rc->pSample);
+                rc->nSampleRate     = 0;
+                rc->nBytes          = 0;
+                rc->nAccess         = 0;
+            }
+        }
+
         void impulse_responses::destroy_file(af_descriptor_t *af)
         {
             // Destroy samples
-            destroy_sample(af->pOriginal);
+            drop_cache(af);
+            release_shared(af->pOriginal);
             destroy_sample(af->pProcessed);
+            destroy_sample(af->pCached);
+            af->nProcessed  = 0;
+            af->nActive     = 0;
 
             // Destroy loader
             if (af->pLoader != NULL)
@@ -227,10 +496,12 @@ namespace lsp
             for (size_t i=0; i < meta::impulse_responses_metadata::FILES_MAX; ++i)
                 c->vPlaybacks[i].destroy();
 
-            destroy_convolver(c->pCurr);
+            c->pCurr        = NULL;
+            c->pFade        = NULL;
+            destroy_convolver(c->pLive);
             destroy_convolver(c->pSwap);
 
-            c->sDelay.destroy();
+            c->sDryDelay.destroy();
             dspu::Sample *gc_list = c->sPlayer.destroy(false);
             destroy_samples(gc_list);
             c->sEqualizer.destroy();
@@ -241,10 +512,63 @@ namespace lsp
             return meta::impulse_responses_metadata::FFT_RANK_MIN + rank;
         }
 
+        size_t impulse_responses::get_latency(size_t latency, size_t rank)
+        {
+            // The latency can not exceed the maximum partition size of the convolver
+            if (latency <= 0)
+                return 0;
+            latency             = meta::impulse_responses_metadata::LATENCY_MIN << (latency - 1);
+            return lsp_min(latency, size_t(1) << (rank - 1));
+        }
+
+        size_t impulse_responses::get_tail_factor(size_t factor)
+        {
+            return (factor == meta::impulse_responses_metadata::TAIL_FACTOR_4) ? 4 : 2;
+        }
+
+        const dspu::Sample *impulse_responses::get_committed(const af_descriptor_t *f)
+        {
+            // Use the re-rendered sample or the one that is currently in use
+            const dspu::Sample *s   = (f->bCommit) ? f->pProcessed : f->pActive;
+            return ((s != NULL) && (s->valid())) ? s : NULL;
+        }
+
+        void impulse_responses::update_equalizer(channel_t *c)
+        {
+            const bool process  = (c->bWetEq) && (!c->bEqBaked);
+            c->sEqualizer.set_mode((process) ? dspu::EQM_IIR : dspu::EQM_BYPASS);
+        }
+
+        bool impulse_responses::playback_active(const channel_t *c)
+        {
+            for (size_t i=0; i<meta::impulse_responses_metadata::FILES_MAX; ++i)
+                if (c->vPlaybacks[i].valid())
+                    return true;
+            return false;
+        }
+
+        size_t impulse_responses::eq_bake_tail() const
+        {
+            return dspu::millis_to_samples(fSampleRate, EQ_BAKE_TAIL);
+        }
+
+        bool impulse_responses::matrix_mode() const
+        {
+            // The first channel owns the convolver for all channels in true stereo mode
+            // and when several outputs are fed from the same input
+            return (bTrueStereo) || (nInputs < nChannels);
+        }
+
+        bool impulse_responses::morph_mode() const
+        {
+            // Each channel morphs between the same tracks of the first and the second file
+            return (bMorph) && (nFiles > 1) && (!matrix_mode());
+        }
+
         void impulse_responses::perform_gc()
         {
             dspu::Sample *gc_list = lsp::atomic_swap(&pGCList, NULL);
-            destroy_samples(gc_list);
+            recycle_samples(gc_list);
         }
 
         void impulse_responses::init(plug::IWrapper *wrapper, plug::IPort **ports)
@@ -256,11 +580,27 @@ namespace lsp
             pExecutor       = wrapper->executor();
             lsp_trace("Executor = %p", pExecutor);
 
+            // Initialize disk cache, the plugin will work without it if the cache directory is not available
+            status_t res    = sDiskCache.init();
+            if (res != STATUS_OK)
+                lsp_warn("Could not initialize disk cache: code=%d (%s)", int(res), get_status(res));
+
+            // Start worker thread, tail partitions will be processed by the audio thread if it is not available
+            res             = sWorker.launch();
+            if (res != STATUS_OK)
+                lsp_warn("Could not start worker thread: code=%d (%s)", int(res), get_status(res));
+
+            // Bind to the shared pool of threads, partitions are transformed by the executor thread if the pool is empty
+            pPool           = IRPool::instance();
+            pPool->bind();
+
             // Allocate buffer data
             size_t tmp_buf_size = TMP_BUF_SIZE * sizeof(float);
             size_t thumbs_size  = meta::impulse_responses_metadata::MESH_SIZE * sizeof(float);
             size_t thumbs_perc  = thumbs_size * meta::impulse_responses_metadata::TRACKS_MAX;
-            size_t alloc        = (tmp_buf_size + thumbs_perc) * nChannels;
+            size_t hist_size    = HISTORY_SIZE * sizeof(float);
+            size_t wet_size     = WET_SIZE * sizeof(float);
+            size_t alloc        = (tmp_buf_size * 3 + hist_size + wet_size) * nChannels + thumbs_perc * nFiles;
             uint8_t *ptr        = alloc_aligned<uint8_t>(pData, alloc, DEFAULT_ALIGN);
             if (ptr == NULL)
                 return;
@@ -274,7 +614,7 @@ namespace lsp
             {
                 channel_t *c    = &vChannels[i];
 
-                if (!c->sPlayer.init(nChannels, 32))
+                if (!c->sPlayer.init(nFiles, 32))
                     return;
                 if (!c->sEqualizer.init(meta::impulse_responses_metadata::EQ_BANDS + 2, CONV_RANK))
                     return;
@@ -284,15 +624,40 @@ namespace lsp
                     c->vPlaybacks[j].construct();
 
                 c->pCurr        = NULL;
+                c->pLive        = NULL;
                 c->pSwap        = NULL;
+                c->pFade        = NULL;
 
                 c->vIn          = NULL;
                 c->vOut         = NULL;
                 c->vBuffer      = advance_ptr_bytes<float>(ptr, tmp_buf_size);
+                c->vWet         = advance_ptr_bytes<float>(ptr, wet_size);
+                c->vDry         = advance_ptr_bytes<float>(ptr, tmp_buf_size);
+                c->vHistory     = advance_ptr_bytes<float>(ptr, hist_size);
+                c->vSwap        = advance_ptr_bytes<float>(ptr, tmp_buf_size);
+                dsp::fill_zero(c->vWet, WET_SIZE);
+                dsp::fill_zero(c->vHistory, HISTORY_SIZE);
 
                 c->fDryGain     = 0.0f;
                 c->fWetGain     = 1.0f;
                 c->nSource      = 0;
+                c->nPredelay    = 0;
+                c->nBypassFade  = 0;
+                c->nSilence     = 0;
+                c->nPrime       = 0;
+                c->nXFade       = 0;
+                c->nXFadeLen    = 0;
+                c->bSleep       = false;
+                c->bBypass      = false;
+                c->bRebuild     = true;
+                c->bCommit      = false;
+                c->bWetEq       = false;
+                c->bEqBake      = false;
+                c->bEqCommit    = false;
+                c->bEqBaked     = false;
+                c->bEqLive      = false;
+                memset(c->vEqParams, 0, sizeof(c->vEqParams));
+                memset(c->vEqCommit, 0, sizeof(c->vEqCommit));
 
                 c->pIn          = NULL;
                 c->pOut         = NULL;
@@ -300,9 +665,11 @@ namespace lsp
                 c->pSource      = NULL;
                 c->pMakeup      = NULL;
                 c->pActivity    = NULL;
+                c->pSleep       = NULL;
                 c->pPredelay    = NULL;
 
                 c->pWetEq       = NULL;
+                c->pWetBake     = NULL;
                 c->pLowCut      = NULL;
                 c->pLowFreq     = NULL;
                 c->pHighCut     = NULL;
@@ -313,31 +680,52 @@ namespace lsp
             }
 
             // Allocate files
-            vFiles          = new af_descriptor_t[nChannels];
+            vFiles          = new af_descriptor_t[nFiles];
             if (vFiles == NULL)
                 return;
 
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<nFiles; ++i)
             {
                 af_descriptor_t *f    = &vFiles[i];
 
                 f->pOriginal    = NULL;
                 f->pProcessed   = NULL;
+                f->pActive      = NULL;
+                f->pCached      = NULL;
 
                 for (size_t j=0; j<meta::impulse_responses_metadata::TRACKS_MAX; ++j)
                     f->vThumbs[j]   = advance_ptr_bytes<float>(ptr, thumbs_size);
+                for (size_t j=0; j<RS_CACHE_SIZE; ++j)
+                {
+                    rs_cache_t *rc      = &f->vCache[j];
+                    rc->pSample         = NULL;
+                    rc->nSampleRate     = 0;
+                    rc->nBytes          = 0;
+                    rc->nAccess         = 0;
+                }
+                IRDiskCache::init_key(&f->sCacheKey);
+                f->nHash        = 0;
+                f->nProcessed   = 0;
+                f->nActive      = 0;
 
                 f->fNorm        = 1.0f;
                 f->nStatus      = STATUS_UNSPECIFIED;
                 f->bSync        = true;
+                f->bRender      = true;
+                f->bCommit      = false;
+                f->bDeferred    = false;
                 f->bReverse     = false;
+                f->bAutoTrim    = false;
                 f->fPitch       = 0.0f;
                 f->fHeadCut     = 0.0f;
                 f->fTailCut     = 0.0f;
                 f->fFadeIn      = 0.0f;
                 f->fFadeOut     = 0.0f;
+                f->fTrimLevel   = meta::impulse_responses_metadata::TRIM_LEVEL_DFL;
+                commit_render_params(f);
 
                 f->fDuration    = 0.0f;
+                f->fRT60        = 0.0f;
 
                 f->pLoader      = new IRLoader(this, f);
                 if (f->pLoader == NULL)
@@ -351,8 +739,12 @@ namespace lsp
                 f->pListen      = NULL;
                 f->pStop        = NULL;
                 f->pReverse     = NULL;
+                f->pAutoTrim    = NULL;
+                f->pTrimLevel   = NULL;
                 f->pStatus      = NULL;
                 f->pLength      = NULL;
+                f->pTrimmed     = NULL;
+                f->pRT60        = NULL;
                 f->pThumbs      = NULL;
             }
 
@@ -360,7 +752,7 @@ namespace lsp
             size_t port_id = 0;
 
             lsp_trace("Binding audio ports");
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<nInputs; ++i)
                 BIND_PORT(vChannels[i].pIn);
             for (size_t i=0; i<nChannels; ++i)
                 BIND_PORT(vChannels[i].pOut);
@@ -369,17 +761,46 @@ namespace lsp
             lsp_trace("Binding common ports");
             BIND_PORT(pBypass);
             BIND_PORT(pRank);
+            BIND_PORT(pLatency);
             BIND_PORT(pDry);
             BIND_PORT(pWet);
             BIND_PORT(pDryWet);
             BIND_PORT(pOutGain);
+            BIND_PORT(pDiskCache);
+            BIND_PORT(pCacheHits);
+            BIND_PORT(pTailOn);
+            BIND_PORT(pTailSplit);
+            BIND_PORT(pTailFactor);
+            BIND_PORT(pTailSaving);
+            BIND_PORT(pHybrid);
+            BIND_PORT(pHybridSplit);
+            BIND_PORT(pHybridError);
+            BIND_PORT(pXFade);
+            BIND_PORT(pSwapLoad);
+            BIND_PORT(pJobsDone);
+            BIND_PORT(pJobsCancelled);
+            BIND_PORT(pBankSlot);
+            BIND_PORT(pBankTarget);
+            BIND_PORT(pBankStore);
+            BIND_PORT(pBankClear);
+            BIND_PORT(pBankLimit);
+            BIND_PORT(pBankStatus);
+            BIND_PORT(pBankUsage);
+            BIND_PORT(pSharedMemory);
+            sBankStore.init();
+            sBankClear.init();
 
             // Skip file selector
-            if (nChannels > 1)
+            if (nFiles > 1)
+            {
                 SKIP_PORT("File selector");
+                BIND_PORT(pTrueStereo);
+                BIND_PORT(pMorph);
+                BIND_PORT(pMorphAmount);
+            }
 
             // Bind impulse file ports
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<nFiles; ++i)
             {
                 lsp_trace("Binding impulse file #%d ports", int(i));
                 af_descriptor_t *f  = &vFiles[i];
@@ -396,8 +817,12 @@ namespace lsp
                 BIND_PORT(f->pListen);
                 BIND_PORT(f->pStop);
                 BIND_PORT(f->pReverse);
+                BIND_PORT(f->pAutoTrim);
+                BIND_PORT(f->pTrimLevel);
                 BIND_PORT(f->pStatus);
                 BIND_PORT(f->pLength);
+                BIND_PORT(f->pTrimmed);
+                BIND_PORT(f->pRT60);
                 BIND_PORT(f->pThumbs);
             }
 
@@ -410,6 +835,7 @@ namespace lsp
                 BIND_PORT(c->pSource);
                 BIND_PORT(c->pMakeup);
                 BIND_PORT(c->pActivity);
+                BIND_PORT(c->pSleep);
                 BIND_PORT(c->pPredelay);
             }
 
@@ -421,6 +847,7 @@ namespace lsp
                 channel_t *c        = &vChannels[i];
 
                 BIND_PORT(c->pWetEq);
+                BIND_PORT(c->pWetBake);
                 SKIP_PORT("Equalizer visibility"); // Skip equalizer visibility port
                 BIND_PORT(c->pLowCut);
                 BIND_PORT(c->pLowFreq);
@@ -443,9 +870,26 @@ namespace lsp
 
         void impulse_responses::do_destroy()
         {
+            // Stop worker thread before destroying convolvers
+            sWorker.shutdown();
+            if (pPool != NULL)
+            {
+                pPool->unbind();
+                pPool           = NULL;
+            }
+
             // Perform garbage collection
             perform_gc();
 
+            // Drop kernels which have not been stored to the disk cache
+            for (size_t i=0; i<nKCQueue; ++i)
+                destroy_kernel(vKCQueue[i].pKernel);
+            nKCQueue        = 0;
+
+            // Destroy the bank, convolvers of slots may be active in channels
+            for (size_t i=0; i<meta::impulse_responses_metadata::BANK_SLOTS; ++i)
+                destroy_slot(&vBank[i]);
+
             // Drop buffers
             if (vChannels != NULL)
             {
@@ -457,50 +901,74 @@ namespace lsp
 
             if (vFiles != NULL)
             {
-                for (size_t i=0; i<nChannels; ++i)
+                for (size_t i=0; i<nFiles; ++i)
                     destroy_file(&vFiles[i]);
 
                 delete [] vFiles;
                 vFiles          = NULL;
             }
 
+            sArena.destroy();
             free_aligned(pData);
         }
 
         void impulse_responses::ui_activated()
         {
             // Force file contents to be synchronized with UI
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<nFiles; ++i)
                 vFiles[i].bSync     = true;
         }
 
         void impulse_responses::update_settings()
         {
             size_t rank         = get_fft_rank(pRank->value());
+            size_t latency      = get_latency(pLatency->value(), rank);
+            bool true_stereo    = (pTrueStereo != NULL) && (pTrueStereo->value() >= 0.5f);
             fGain               = pOutGain->value();
-            if (rank != nRank)
+            bDiskCache          = pDiskCache->value() >= 0.5f;
+            size_t tail_factor  = (pTailOn->value() >= 0.5f) ? get_tail_factor(pTailFactor->value()) : 0;
+            float tail_split    = pTailSplit->value();
+            bool hybrid         = pHybrid->value() >= 0.5f;
+            float hybrid_split  = pHybridSplit->value();
+            bool morph          = (pMorph != NULL) && (pMorph->value() >= 0.5f);
+            if ((rank != nRank) || (latency != nLatency) || (true_stereo != bTrueStereo) || (morph != bMorph) ||
+                (tail_factor != nTailFactor) || ((tail_factor > 0) && (tail_split != fTailSplit)) ||
+                (hybrid != bHybrid) || ((hybrid) && (hybrid_split != fHybridSplit)))
             {
+                // Changing the FFT rank, latency, routing or processing of the tail requires all convolvers to be rebuilt
+                for (size_t i=0; i<nChannels; ++i)
+                    vChannels[i].bRebuild   = true;
                 ++nReconfigReq;
                 nRank               = rank;
+                nLatency            = latency;
+                bTrueStereo         = true_stereo;
+                nTailFactor         = tail_factor;
+                fTailSplit          = tail_split;
+                bHybrid             = hybrid;
+                fHybridSplit        = hybrid_split;
+                bMorph              = morph;
             }
 
+            // The morph amount is applied without rebuilding convolvers
+            fMorph              = (pMorphAmount != NULL) ? pMorphAmount->value() * 0.01f : 0.0f;
             for (size_t i=0; i<nChannels; ++i)
             {
-                channel_t *c        = &vChannels[i];
-                af_descriptor_t *f  = &vFiles[i];
-
-                const float drywet  = pDryWet->value() * 0.01f;
-                const float dry     = pDry->value();
-                const float wet     = pWet->value() * c->pMakeup->value();
-
-                c->fDryGain         = (dry * drywet + 1.0f - drywet) * fGain;
-                c->fWetGain         = wet * drywet * fGain;
+                IRConvolver *cv     = vChannels[i].pCurr;
+                if (cv != NULL)
+                    cv->set_morph(fMorph);
+            }
+            nXFade              = dspu::millis_to_samples(fSampleRate, pXFade->value());
 
-                // Update delay and bypass configuration
-                c->sPlayer.set_gain(fGain);
-                c->sDelay.set_delay(dspu::millis_to_samples(fSampleRate, c->pPredelay->value()));
-                c->sBypass.set_bypass(pBypass->value() >= 0.5f);
+            // Bank slots are switched and stored by the real-time thread
+            nSlotReq            = pBankSlot->value();
+            nBankTarget         = pBankTarget->value() + 1;
+            nBankLimit          = size_t(64) << (20 + size_t(pBankLimit->value()));
+            sBankStore.submit(pBankStore->value());
+            sBankClear.submit(pBankClear->value());
 
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                af_descriptor_t *f  = &vFiles[i];
                 // Check that file parameters have changed
                 float pitch         = f->pPitch->value();
                 float head_cut      = f->pHeadCut->value();
@@ -508,12 +976,16 @@ namespace lsp
                 float fade_in       = f->pFadeIn->value();
                 float fade_out      = f->pFadeOut->value();
                 bool reverse        = f->pReverse->value() >= 0.5f;
+                bool auto_trim      = f->pAutoTrim->value() >= 0.5f;
+                float trim_level    = f->pTrimLevel->value();
                 if ((f->fPitch != pitch) ||
                     (f->fHeadCut != head_cut) ||
                     (f->fTailCut != tail_cut) ||
                     (f->fFadeIn  != fade_in ) ||
                     (f->fFadeOut != fade_out) ||
-                    (f->bReverse != reverse))
+                    (f->bReverse != reverse) ||
+                    (f->bAutoTrim != auto_trim) ||
+                    ((auto_trim) && (f->fTrimLevel != trim_level)))
                 {
                     f->fPitch           = pitch;
                     f->fHeadCut         = head_cut;
@@ -521,6 +993,9 @@ namespace lsp
                     f->fFadeIn          = fade_in;
                     f->fFadeOut         = fade_out;
                     f->bReverse         = reverse;
+                    f->bAutoTrim        = auto_trim;
+                    f->fTrimLevel       = trim_level;
+                    f->bRender          = true;
                     nReconfigReq        ++;
                 }
 
@@ -529,119 +1004,223 @@ namespace lsp
                     f->sListen.submit(f->pListen->value());
                 if (f->pStop != NULL)
                     f->sStop.submit(f->pStop->value());
+            }
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+
+                const float drywet  = pDryWet->value() * 0.01f;
+                const float dry     = pDry->value();
+                const float wet     = pWet->value() * c->pMakeup->value();
+
+                c->fDryGain         = (dry * drywet + 1.0f - drywet) * fGain;
+                c->fWetGain         = wet * drywet * fGain;
+
+                // Update delay and bypass configuration
+                c->sPlayer.set_gain(fGain);
+                c->nPredelay        = lsp_min(dspu::millis_to_samples(fSampleRate, c->pPredelay->value()), PREDELAY_LIMIT);
+                const bool bypass   = pBypass->value() >= 0.5f;
+                if (bypass != c->bBypass)
+                {
+                    c->bBypass          = bypass;
+                    c->nBypassFade      = dspu::millis_to_samples(fSampleRate, BYPASS_FADE) + 1;
+                }
+                c->sBypass.set_bypass(bypass);
 
                 size_t source       = c->pSource->value();
                 if (source != c->nSource)
                 {
-                    ++nReconfigReq;
                     c->nSource          = source;
+                    c->bRebuild         = true;
+                    ++nReconfigReq;
                 }
 
-                // Update equalization parameters
-                dspu::Equalizer *eq             = &c->sEqualizer;
-                dspu::equalizer_mode_t eq_mode  = (c->pWetEq->value() >= 0.5f) ? dspu::EQM_IIR : dspu::EQM_BYPASS;
-                eq->set_mode(eq_mode);
+                // Compute equalization parameters
+                const size_t n_filters  = meta::impulse_responses_metadata::EQ_BANDS + 2;
+                dspu::filter_params_t params[n_filters];
+                memset(params, 0, sizeof(params)); // Clear padding of structures for comparison
+                size_t band     = 0;
 
-                if (eq_mode != dspu::EQM_BYPASS)
+                // Set-up parametric equalizer
+                while (band < meta::impulse_responses_metadata::EQ_BANDS)
                 {
-                    dspu::filter_params_t fp;
-                    size_t band     = 0;
-
-                    // Set-up parametric equalizer
-                    while (band < meta::impulse_responses_metadata::EQ_BANDS)
+                    dspu::filter_params_t *fp   = &params[band];
+                    if (band == 0)
                     {
-                        if (band == 0)
-                        {
-                            fp.fFreq        = band_freqs[band];
-                            fp.fFreq2       = fp.fFreq;
-                            fp.nType        = dspu::FLT_MT_LRX_LOSHELF;
-                        }
-                        else if (band == (meta::impulse_responses_metadata::EQ_BANDS - 1))
-                        {
-                            fp.fFreq        = band_freqs[band-1];
-                            fp.fFreq2       = fp.fFreq;
-                            fp.nType        = dspu::FLT_MT_LRX_HISHELF;
-                        }
-                        else
-                        {
-                            fp.fFreq        = band_freqs[band-1];
-                            fp.fFreq2       = band_freqs[band];
-                            fp.nType        = dspu::FLT_MT_LRX_LADDERPASS;
-                        }
+                        fp->fFreq       = band_freqs[band];
+                        fp->fFreq2      = fp->fFreq;
+                        fp->nType       = dspu::FLT_MT_LRX_LOSHELF;
+                    }
+                    else if (band == (meta::impulse_responses_metadata::EQ_BANDS - 1))
+                    {
+                        fp->fFreq       = band_freqs[band-1];
+                        fp->fFreq2      = fp->fFreq;
+                        fp->nType       = dspu::FLT_MT_LRX_HISHELF;
+                    }
+                    else
+                    {
+                        fp->fFreq       = band_freqs[band-1];
+                        fp->fFreq2      = band_freqs[band];
+                        fp->nType       = dspu::FLT_MT_LRX_LADDERPASS;
+                    }
 
-                        fp.fGain        = c->pFreqGain[band]->value();
-                        fp.nSlope       = 2;
-                        fp.fQuality     = 0.0f;
+                    fp->fGain       = c->pFreqGain[band]->value();
+                    fp->nSlope      = 2;
+                    fp->fQuality    = 0.0f;
+                    ++band;
+                }
 
-                        // Update filter parameters
-                        eq->set_params(band++, &fp);
-                    }
+                // Setup hi-pass filter
+                dspu::filter_params_t *fp   = &params[band++];
+                size_t hp_slope = c->pLowCut->value() * 2;
+                fp->nType       = (hp_slope > 0) ? dspu::FLT_BT_BWC_HIPASS : dspu::FLT_NONE;
+                fp->fFreq       = c->pLowFreq->value();
+                fp->fFreq2      = fp->fFreq;
+                fp->fGain       = 1.0f;
+                fp->nSlope      = hp_slope;
+                fp->fQuality    = 0.0f;
+
+                // Setup low-pass filter
+                fp              = &params[band++];
+                size_t lp_slope = c->pHighCut->value() * 2;
+                fp->nType       = (lp_slope > 0) ? dspu::FLT_BT_BWC_LOPASS : dspu::FLT_NONE;
+                fp->fFreq       = c->pHighFreq->value();
+                fp->fFreq2      = fp->fFreq;
+                fp->fGain       = 1.0f;
+                fp->nSlope      = lp_slope;
+                fp->fQuality    = 0.0f;
+
+                // Baked equalizer requires the convolver to be rebuilt on each change
+                const bool wet_eq       = c->pWetEq->value() >= 0.5f;
+                const bool bake         = (wet_eq) && (c->pWetBake->value() >= 0.5f);
+                const bool changed      = memcmp(params, c->vEqParams, sizeof(params)) != 0;
+                if ((bake != c->bEqBake) || ((bake) && (changed)))
+                {
+                    c->bRebuild         = true;
+                    ++nReconfigReq;
+                }
+                c->bWetEq           = wet_eq;
+                c->bEqBake          = bake;
 
-                    // Setup hi-pass filter
-                    size_t hp_slope = c->pLowCut->value() * 2;
-                    fp.nType        = (hp_slope > 0) ? dspu::FLT_BT_BWC_HIPASS : dspu::FLT_NONE;
-                    fp.fFreq        = c->pLowFreq->value();
-                    fp.fFreq2       = fp.fFreq;
-                    fp.fGain        = 1.0f;
-                    fp.nSlope       = hp_slope;
-                    fp.fQuality     = 0.0f;
-                    eq->set_params(band++, &fp);
-
-                    // Setup low-pass filter
-                    size_t lp_slope = c->pHighCut->value() * 2;
-                    fp.nType        = (lp_slope > 0) ? dspu::FLT_BT_BWC_LOPASS : dspu::FLT_NONE;
-                    fp.fFreq        = c->pHighFreq->value();
-                    fp.fFreq2       = fp.fFreq;
-                    fp.fGain        = 1.0f;
-                    fp.nSlope       = lp_slope;
-                    fp.fQuality     = 0.0f;
-                    eq->set_params(band++, &fp);
+                // Update equalizer
+                if (changed)
+                {
+                    memcpy(c->vEqParams, params, sizeof(params));
+                    for (size_t j=0; j<n_filters; ++j)
+                        c->sEqualizer.set_params(j, &params[j]);
                 }
+                update_equalizer(c);
             }
         }
 
         void impulse_responses::update_sample_rate(long sr)
         {
+            // Sample rate affects both rendered files and convolvers
+            for (size_t i=0; i<nFiles; ++i)
+                vFiles[i].bRender   = true;
+            ++nReconfigReq;
+            nHistFill       = 0;
+
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c = &vChannels[i];
-                ++nReconfigReq;
-
-                c->sBypass.init(sr);
-                c->sDelay.init(dspu::millis_to_samples(sr, meta::impulse_responses_metadata::PREDELAY_MAX));
+                c->bRebuild     = true;
+                c->nPrime       = 0;
+                c->nXFade       = 0;
+
+                c->sBypass.init(sr, BYPASS_FADE * 0.001f);
+                c->nBypassFade  = dspu::millis_to_samples(sr, BYPASS_FADE) + 1;
+                c->sDryDelay.init(meta::impulse_responses_metadata::LATENCY_MAX);
+                c->sDryDelay.set_delay(nDelay);
+                dsp::fill_zero(c->vWet, WET_SIZE);
                 c->sEqualizer.set_sample_rate(sr);
             }
         }
 
         bool impulse_responses::has_active_loading_tasks()
         {
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<nFiles; ++i)
                 if (!vFiles[i].pLoader->idle())
                     return true;
             return false;
         }
 
-        void impulse_responses::process_loading_tasks()
+        size_t impulse_responses::loading_mask() const
         {
-            // Do nothing with loading while configurator is active
-            if (!sConfigurator.idle())
-                return;
+            size_t mask         = 0;
+            for (size_t i=0; i<nFiles; ++i)
+                if (!vFiles[i].pLoader->idle())
+                    mask               |= size_t(1) << i;
+            return mask;
+        }
 
-            // Process each audio file
+        size_t impulse_responses::source_mask(const channel_t *c) const
+        {
+            // The true stereo convolver depends on all files, the morphing convolver - on both files
+            if (bTrueStereo)
+                return (size_t(1) << nFiles) - 1;
+            if (c->nSource <= 0)
+                return 0;
+
+            const size_t file   = (c->nSource - 1) / meta::impulse_responses_metadata::TRACKS_MAX;
+            size_t mask         = (file < nFiles) ? size_t(1) << file : 0;
+            if ((morph_mode()) && ((file ^ 1) < nFiles))
+                mask               |= size_t(1) << (file ^ 1);
+            return mask;
+        }
+
+        size_t impulse_responses::channel_mask(size_t channel) const
+        {
+            // The shared convolver depends on sources of all channels
+            if (!matrix_mode())
+                return source_mask(&vChannels[channel]);
+
+            size_t mask         = 0;
+            for (size_t i=0; i<nChannels; ++i)
+                mask               |= source_mask(&vChannels[i]);
+            return mask;
+        }
+
+        bool impulse_responses::job_obsolete() const
+        {
+            // The job is obsolete only if the data it renders has been requested again
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                const af_descriptor_t *f    = &vFiles[i];
+                if ((f->bCommit) && (f->bRender))
+                    return true;
+            }
             for (size_t i=0; i<nChannels; ++i)
+            {
+                const channel_t *c  = &vChannels[i];
+                if ((c->bCommit) && (c->bRebuild))
+                    return true;
+            }
+            return false;
+        }
+
+        void impulse_responses::process_loading_tasks()
+        {
+            // Process each audio file
+            for (size_t i=0; i<nFiles; ++i)
             {
                 af_descriptor_t *af     = &vFiles[i];
                 if (af->pFile == NULL)
                     continue;
 
-                // Get path and check task state
+                // Get path and check task state, the file used by the active configurator can not be loaded
                 if (af->pLoader->idle())
                 {
+                    if ((!sConfigurator.idle()) && (nJobFiles & (size_t(1) << i)))
+                        continue;
+
                     // Get path
                     plug::path_t *path      = af->pFile->buffer<plug::path_t>();
                     if ((path != NULL) && (path->pending()))
                     {
-                        // Try to submit task
+                        // Try to submit task, the loader looks up the disk cache with the snapshot of parameters
+                        commit_render_params(af);
                         if (pExecutor->submit(af->pLoader))
                         {
                             lsp_trace("Successfully submitted load task for file %d", int(i));
@@ -657,6 +1236,7 @@ namespace lsp
                     {
                         // Update file status and set re-rendering flag
                         af->nStatus         = af->pLoader->code();
+                        af->bRender         = true;
                         ++nReconfigReq;
 
                         // Now we surely can commit changes and reset task state
@@ -667,42 +1247,247 @@ namespace lsp
             } // for
         }
 
-        void impulse_responses::process_configuration_tasks()
+        void impulse_responses::commit_settings()
         {
-            // Do nothing if at least one loader is active
-            if (has_active_loading_tasks())
-                return;
+            // The configurator works with the snapshot, so settings may change while it is running
+            sJob.nRank          = nRank;
+            sJob.nLatency       = nLatency;
+            sJob.nTailFactor    = nTailFactor;
+            sJob.fTailSplit     = fTailSplit;
+            sJob.fHybridSplit   = fHybridSplit;
+            sJob.bHybrid        = bHybrid;
+            sJob.bTrueStereo    = bTrueStereo;
+            sJob.bMatrix        = matrix_mode();
+            sJob.bMorph         = morph_mode();
+            sJob.bDiskCache     = bDiskCache;
+        }
 
-            // Check the status and look for a job
-            if ((nReconfigReq != nReconfigResp) && (sConfigurator.idle()))
+        bool impulse_responses::submit_configuration_task()
+        {
+            // Move pending requests to the commit state, the configurator will process only them.
+            // Files which are being loaded stay pending, the loader requests reconfiguration when it completes
+            const size_t loading    = loading_mask();
+            for (size_t i=0; i<nFiles; ++i)
             {
-                // Try to submit task
-                if (pExecutor->submit(&sConfigurator))
-                {
-                    // Clear render state and reconfiguration request
-                    nReconfigResp   = nReconfigReq;
-                    lsp_trace("Successfully submitted reconfiguration task");
-                }
+                af_descriptor_t *f  = &vFiles[i];
+                f->bCommit          = (f->bRender) && (!(loading & (size_t(1) << i)));
+                f->bRender          = (f->bRender) && (!f->bCommit);
+                if (f->bCommit)
+                    commit_render_params(f);
             }
-            else if (sConfigurator.completed())
+
+            for (size_t i=0; i<nChannels; ++i)
             {
-                // Update state for channels
-                for (size_t i=0; i<nChannels; ++i)
-                {
-                    channel_t *c        = &vChannels[i];
+                channel_t *c        = &vChannels[i];
+                c->bCommit          = c->bRebuild;
+                c->bRebuild         = false;
+
+                // Pass the snapshot of the wet equalizer to the configurator
+                c->bEqCommit        = c->bEqBake;
+                memcpy(c->vEqCommit, c->vEqParams, sizeof(c->vEqParams));
+
+                // Convolver also needs to be rebuilt if any of its source files is re-rendered
+                const size_t mask   = source_mask(c);
+                for (size_t j=0; j<nFiles; ++j)
+                    if ((mask & (size_t(1) << j)) && (vFiles[j].bCommit))
+                        c->bCommit          = true;
+            }
 
-                    // Commit new convolver
-                    lsp::swap(c->pCurr, c->pSwap);
-                }
+            // The shared convolver of the first channel depends on changes of all channels
+            if (matrix_mode())
+            {
+                for (size_t i=1; i<nChannels; ++i)
+                    if (vChannels[i].bCommit)
+                        vChannels[0].bCommit    = true;
+            }
 
-                // Bind processed samples to the sampler
-                for (size_t i=0; i<nChannels; ++i)
-                {
+            // Channels which depend on files being loaded are rebuilt later, other channels are committed independently
+            nJobFiles           = 0;
+            for (size_t i=0; i<nFiles; ++i)
+                if (vFiles[i].bCommit)
+                    nJobFiles          |= size_t(1) << i;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                if (!c->bCommit)
+                    continue;
+
+                const size_t mask   = channel_mask(i);
+                if (mask & loading)
+                {
+                    c->bRebuild         = true;
+                    c->bCommit          = false;
+                }
+                else
+                    nJobFiles          |= mask;
+            }
+
+            // Try to submit task
+            commit_settings();
+            atomic_store(&nCancel, 0);
+            if (pExecutor->submit(&sConfigurator))
+                return true;
+
+            // Submit failed, return requests back to the pending state
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                af_descriptor_t *f  = &vFiles[i];
+                f->bRender          = f->bRender || f->bCommit;
+                f->bCommit          = false;
+            }
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->bRebuild         = c->bRebuild || c->bCommit;
+                c->bCommit          = false;
+            }
+
+            return false;
+        }
+
+        void impulse_responses::cancel_configuration_task()
+        {
+            // Return requests of the cancelled job back to the pending state, the job is re-submitted
+            // with the latest settings. Partially built data is destroyed by the next run of the configurator
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                af_descriptor_t *f  = &vFiles[i];
+                f->bRender          = f->bRender || f->bCommit;
+                f->bCommit          = false;
+            }
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->bRebuild         = c->bRebuild || c->bCommit;
+                c->bCommit          = false;
+            }
+
+            ++nJobsCancelled;
+            lsp_trace("Cancelled reconfiguration task, completed=%d, cancelled=%d", int(nJobsDone), int(nJobsCancelled));
+        }
+
+        bool impulse_responses::cancelled() const
+        {
+            return atomic_load(&nCancel) != 0;
+        }
+
+        bool impulse_responses::render_pending() const
+        {
+            for (size_t i=0; i<nFiles; ++i)
+                if (vFiles[i].bRender)
+                    return true;
+            return false;
+        }
+
+        void impulse_responses::process_configuration_tasks(size_t samples)
+        {
+            // The settings are stable if there were no reconfiguration requests for the settle time
+            if (nSettleReq != nReconfigReq)
+            {
+                nSettleReq      = nReconfigReq;
+                nSettle         = dspu::millis_to_samples(fSampleRate, PREVIEW_SETTLE);
+            }
+            else
+                nSettle        -= lsp_min(nSettle, samples);
+
+            // The running reconfiguration is obsolete if its data is requested again, the store is not interrupted
+            if ((!sConfigurator.idle()) && (!sConfigurator.completed()) &&
+                (nStoreSlot == 0) && (nReconfigReq != nReconfigResp) && (job_obsolete()))
+                atomic_store(&nCancel, 1);
+
+            // The previous convolver is in use until the swap completes
+            if (swap_active())
+                return;
+
+            // Check the status and look for a job, the live convolvers are rebuilt prior to storing them to the bank.
+            // The configurator destroys convolvers, so it should not run together with the preparer
+            if (sConfigurator.idle())
+            {
+                if (!sPreparer.idle())
+                    return;
+
+                // Try to submit task, files are rendered as the truncated preview until the settings become stable
+                if (nReconfigReq != nReconfigResp)
+                {
+                    bPreview        = (nSettle > 0) && (render_pending());
+                    if (submit_configuration_task())
+                    {
+                        // Clear render state and reconfiguration request
+                        nReconfigResp   = nReconfigReq;
+                        lsp_trace("Successfully submitted %s reconfiguration task", (bPreview) ? "preview" : "full");
+                    }
+                }
+                else if (bRefine)
+                {
+                    // Replace the preview by the full render
+                    bPreview        = false;
+                    if ((nSettle <= 0) && (submit_configuration_task()))
+                    {
+                        bRefine         = false;
+                        lsp_trace("Successfully submitted refining reconfiguration task");
+                    }
+                }
+                else if ((nStoreReq > 0) && (!has_active_loading_tasks()))
+                {
+                    if (submit_store_task())
+                        lsp_trace("Successfully submitted store task for bank slot %d", int(nStoreSlot));
+                }
+            }
+            else if (sConfigurator.completed())
+            {
+                // The configurator has built convolvers of the bank slot
+                if (nStoreSlot > 0)
+                {
+                    commit_store();
+                    sConfigurator.reset();
+                    return;
+                }
+
+                // Nothing to commit if the job has been stopped by the newer request
+                if (sConfigurator.code() == STATUS_CANCELLED)
+                {
+                    cancel_configuration_task();
+                    sConfigurator.reset();
+                    return;
+                }
+                ++nJobsDone;
+
+                // Commit only convolvers that have been rebuilt
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c        = &vChannels[i];
+                    if (!c->bCommit)
+                        continue;
+
+                    // Commit new convolver, the equalizer is disabled if it has been baked into the convolver.
+                    // The live convolver is activated only if no slot of the bank is in use
+                    lsp::swap(c->pLive, c->pSwap);
+                    c->bEqLive          = c->bEqCommit;
+                    c->bCommit          = false;
+                    if (nSlot == 0)
+                        activate(c, c->pLive, c->bEqLive);
+                }
+
+                // Bind re-rendered samples to the sampler, the preview of the file should be rendered again
+                for (size_t i=0; i<nFiles; ++i)
+                {
                     af_descriptor_t *f  = &vFiles[i];
+                    if (!f->bCommit)
+                        continue;
+
                     for (size_t j=0; j<nChannels; ++j)
                         vChannels[j].sPlayer.bind(i, f->pProcessed);
+                    f->pActive      = f->pProcessed;
+                    f->nActive      = f->nProcessed;
                     f->pProcessed   = NULL;
+                    f->nProcessed   = 0;
                     f->bSync        = true;
+                    f->bCommit      = false;
+                    if (bPreview)
+                    {
+                        f->bRender      = true;
+                        bRefine         = true;
+                    }
                 }
 
                 // Reset configurator task
@@ -710,6 +1495,95 @@ namespace lsp
             }
         }
 
+        void impulse_responses::process_prepare_tasks()
+        {
+            if (sPreparer.completed())
+                sPreparer.reset();
+
+            // Live convolvers are prepared level by level, so the configurator is not blocked for long
+            if ((sPreparer.idle()) && (sConfigurator.idle()) && (prepare_pending()))
+                pExecutor->submit(&sPreparer);
+        }
+
+        bool impulse_responses::prepare_pending() const
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const IRConvolver *cv   = vChannels[i].pLive;
+                if ((cv != NULL) && (!cv->prepared()))
+                    return true;
+            }
+            return nKCQueue > 0;
+        }
+
+        status_t impulse_responses::prepare_convolvers()
+        {
+            // Transform the next level of each live convolver
+            bool pending        = false;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                IRConvolver *cv     = vChannels[i].pLive;
+                if ((cv == NULL) || (cv->prepared()))
+                    continue;
+                if (!cv->prepare(pPool))
+                    return STATUS_NO_MEM;
+                pending             = true;
+            }
+
+            // Kernels are stored to the disk cache after live convolvers have been prepared
+            if ((!pending) && (!store_kernels()))
+                return STATUS_NO_MEM;
+
+            return STATUS_OK;
+        }
+
+        void impulse_responses::run_batch(IRBatch *batch, size_t count)
+        {
+            if (pPool != NULL)
+            {
+                pPool->run(batch, count, NULL);
+                return;
+            }
+
+            for (size_t i=0; i<count; ++i)
+                batch->execute(i, NULL);
+        }
+
+        void impulse_responses::queue_kernel(IRKernel *k, const IRRegistry::kernel_key_t *key)
+        {
+            // Kernels are queued by channels built in parallel
+            const size_t index  = atomic_add(&nKCQueue, uatomic_t(1));
+            if (index >= KC_QUEUE_SIZE)
+            {
+                atomic_add(&nKCQueue, uatomic_t(-1));
+                return;
+            }
+
+            kc_request_t *r     = &vKCQueue[index];
+            r->pKernel          = k->acquire();
+            r->sKey             = *key;
+        }
+
+        bool impulse_responses::store_kernels()
+        {
+            if (nKCQueue <= 0)
+                return true;
+
+            // Kernels which are not used by live convolvers are prepared here level by level
+            kc_request_t *r     = &vKCQueue[nKCQueue - 1];
+            IRKernel *k         = r->pKernel;
+            if (!k->prepared())
+                return k->prepare(pPool);
+
+            status_t res        = sDiskCache.store_kernel(k, &r->sKey);
+            if (res != STATUS_OK)
+                lsp_warn("Error storing kernel to disk cache: code=%d (%s)", int(res), get_status(res));
+            destroy_kernel(r->pKernel);
+            --nKCQueue;
+
+            return true;
+        }
+
         void impulse_responses::process_gc_events()
         {
             if (sGCTask.completed())
@@ -734,350 +1608,1741 @@ namespace lsp
             const size_t fadeout = dspu::millis_to_samples(fSampleRate, 5.0f);
             dspu::PlaySettings ps;
 
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                af_descriptor_t *f  = &vFiles[i];
+
+                // Need to start audio preview playback?
+                if (f->sListen.pending())
+                {
+                    lsp_trace("Submitted listen toggle");
+                    dspu::Sample *s = vChannels[0].sPlayer.get(i);
+                    const size_t n_c = (s != NULL) ? s->channels() : 0;
+                    if (n_c > 0)
+                    {
+                        for (size_t j=0; j<nChannels; ++j)
+                        {
+                            channel_t *c = &vChannels[j];
+                            ps.set_channel(i, j % n_c);
+                            ps.set_playback(0, 0, GAIN_AMP_0_DB);
+
+                            c->vPlaybacks[i].cancel(fadeout, 0);
+                            c->vPlaybacks[i] = c->sPlayer.play(&ps);
+                        }
+                    }
+                    f->sListen.commit();
+                }
+
+                // Need to cancel audio preview playback?
+                if (f->sStop.pending())
+                {
+                    for (size_t j=0; j<nChannels; ++j)
+                    {
+                        channel_t *c = &vChannels[j];
+                        c->vPlaybacks[i].cancel(fadeout, 0);
+                    }
+                    f->sStop.commit();
+                }
+            }
+        }
+
+        void impulse_responses::perform_convolution(size_t samples)
+        {
+            // Get pointers to data channels
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+
+                // Channels without own input share the input of the first channel
+                c->vIn          = (c->pIn != NULL) ? c->pIn->buffer<float>() : vChannels[0].vIn;
+                c->vOut         = c->pOut->buffer<float>();
+            }
+
+            // Process samples
+            while (samples > 0)
+            {
+                // The block does not cross the end of delay lines of the wet signal
+                size_t to_do        = lsp_min(TMP_BUF_SIZE, WET_SIZE - nWetPos);
+                if (to_do > samples)
+                    to_do               = samples;
+                record_history(to_do);
+
+                // Do convolution directly into delay lines, the shared convolver processes all channels at once
+                IRConvolver *mx     = vChannels[0].pCurr;
+                if ((mx != NULL) && (mx->outputs() > 1))
+                {
+                    float *dst[IRConvolver::CHANNELS_MAX];
+                    const float *src[IRConvolver::CHANNELS_MAX];
+                    for (size_t i=0; i<mx->inputs(); ++i)
+                        src[i]          = vChannels[i].vIn;
+                    for (size_t i=0; i<mx->outputs(); ++i)
+                        dst[i]          = &vChannels[i].vWet[nWetPos];
+                    convolve(&vChannels[0], dst, src, to_do);
+                }
+                else
+                {
+                    for (size_t i=0; i<nChannels; ++i)
+                    {
+                        channel_t *c    = &vChannels[i];
+                        float *wet      = &c->vWet[nWetPos];
+                        if (c->pCurr != NULL)
+                            convolve(c, &wet, &c->vIn, to_do);
+                        else
+                            dsp::fill_zero(wet, to_do);
+                    }
+                }
+
+                // Align dry signal with the latency of convolution. The input can be shared between
+                // channels, so it should be copied before any output is written
+                const bool copy_dry = (nDelay > 0) || (nInputs < nChannels);
+                if (copy_dry)
+                {
+                    for (size_t i=0; i<nChannels; ++i)
+                    {
+                        channel_t *c    = &vChannels[i];
+                        c->sDryDelay.process(c->vDry, c->vIn, to_do);
+                    }
+                }
+
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c        = &vChannels[i];
+                    const float *dry    = (copy_dry) ? c->vDry : c->vIn;
+
+                    // Process wet signal in the delay line, skip inactive stages
+                    if ((c->bWetEq) && (!c->bEqBaked))
+                        c->sEqualizer.process(&c->vWet[nWetPos], &c->vWet[nWetPos], to_do);
+
+                    const bool playback = playback_active(c);
+                    if ((c->bBypass) && (c->nBypassFade <= 0))
+                    {
+                        if (playback) // Keep playback position running
+                            c->sPlayer.process(c->vBuffer, c->vBuffer, to_do);
+                        dsp::copy(c->vOut, dry, to_do);
+                    }
+                    else
+                    {
+                        // Mix the delayed wet signal taken from the delay line with the dry signal in one pass,
+                        // the delayed block wraps around the end of the delay line at most once
+                        float *dst          = (c->nBypassFade > 0) ? c->vBuffer : c->vOut;
+                        size_t pos          = (nWetPos - c->nPredelay) & (WET_SIZE - 1);
+                        for (size_t off=0; off < to_do; )
+                        {
+                            const size_t n      = lsp_min(to_do - off, WET_SIZE - pos);
+                            dsp::mix_copy2(&dst[off], &c->vWet[pos], &dry[off], c->fWetGain, c->fDryGain, n);
+                            pos                 = (pos + n) & (WET_SIZE - 1);
+                            off                += n;
+                        }
+                        if (playback)
+                            c->sPlayer.process(dst, dst, to_do);
+
+                        // The bypass is processed only while it switches
+                        if (c->nBypassFade > 0)
+                        {
+                            c->sBypass.process(c->vOut, dry, c->vBuffer, to_do);
+                            c->nBypassFade      = (c->nBypassFade > to_do) ? c->nBypassFade - to_do : 0;
+                        }
+                    }
+
+                    // Update pointers
+                    c->vIn             += to_do;
+                    c->vOut            += to_do;
+                }
+
+                nWetPos             = (nWetPos + to_do) & (WET_SIZE - 1);
+                samples            -= to_do;
+            }
+        }
+
+        void impulse_responses::record_history(size_t count)
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                const size_t head   = lsp_min(count, HISTORY_SIZE - nHistPos);
+                dsp::copy(&c->vHistory[nHistPos], c->vIn, head);
+                dsp::copy(c->vHistory, &c->vIn[head], count - head);
+            }
+
+            nHistPos            = (nHistPos + count) & (HISTORY_SIZE - 1);
+            nHistFill           = lsp_min(nHistFill + count, PRIME_MAX);
+        }
+
+        bool impulse_responses::swap_active() const
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const channel_t *c  = &vChannels[i];
+                if ((c->nPrime > 0) || (c->nXFade > 0))
+                    return true;
+            }
+            return false;
+        }
+
+        void impulse_responses::process_bank_events()
+        {
+            // Store and clear requests are executed by the configurator
+            if (sBankStore.pending())
+            {
+                nStoreReq           = nBankTarget;
+                nBankStatus         = STATUS_IN_PROCESS;
+                sBankStore.commit();
+            }
+            if (sBankClear.pending())
+            {
+                nClearReq           = nBankTarget;
+                sBankClear.commit();
+            }
+
+            // Switch the slot at the block boundary, the running swap completes first
+            const size_t slot   = (slot_ready(nSlotReq)) ? nSlotReq : 0;
+            if ((slot != nSlot) && (!swap_active()))
+                select_slot(slot);
+
+            // The slot is cleared when it is not in use, the configurator destroys its convolvers
+            if ((nClearReq > 0) && (nClearReq != nSlot) && (nClearReq != nStoreSlot) &&
+                (sConfigurator.idle()) && (!swap_active()))
+            {
+                vBank[nClearReq - 1].bUsed  = false;
+                if (nStoreReq == nClearReq)
+                    nStoreReq           = 0;
+                nClearReq           = 0;
+                ++nReconfigReq;
+            }
+        }
+
+        bool impulse_responses::slot_ready(size_t slot) const
+        {
+            if ((slot <= 0) || (slot > meta::impulse_responses_metadata::BANK_SLOTS) || (slot == nClearReq))
+                return false;
+
+            // Convolvers of the slot should match the current latency and sample rate
+            const bank_slot_t *b    = &vBank[slot - 1];
+            return (b->bUsed) && (b->nLatency == nLatency) && (b->nSampleRate == size_t(fSampleRate));
+        }
+
+        void impulse_responses::select_slot(size_t slot)
+        {
+            const bank_slot_t *b    = (slot > 0) ? &vBank[slot - 1] : NULL;
+            nSlot               = slot;
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                IRConvolver *cv     = (b != NULL) ? b->vConv[i] : c->pLive;
+                if (cv == c->pCurr)
+                    continue;
+
+                // The state of the convolver has been left since it was active the last time
+                if (cv != NULL)
+                    cv->clear();
+                activate(c, cv, (b != NULL) ? b->vEqBaked[i] : c->bEqLive);
+            }
+        }
+
+        void impulse_responses::activate(channel_t *c, IRConvolver *cv, bool eq_baked)
+        {
+            // The previous convolver is faded out, the equalizer is disabled if it has been baked into the convolver
+            c->pFade            = c->pCurr;
+            c->pCurr            = cv;
+            if (cv != NULL)
+                cv->set_morph(fMorph);
+            begin_swap(c);
+            c->nSilence         = 0;
+            c->bSleep           = false;
+            c->bEqBaked         = eq_baked;
+            update_equalizer(c);
+
+            // The latency is reported only when the convolver built with the new latency goes live
+            commit_latency();
+        }
+
+        void impulse_responses::commit_latency()
+        {
+            size_t latency      = 0;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const IRConvolver *cv   = vChannels[i].pCurr;
+                if (cv != NULL)
+                    latency             = lsp_max(latency, cv->latency());
+            }
+            latency             = lsp_min(latency, meta::impulse_responses_metadata::LATENCY_MAX);
+            if (latency == nDelay)
+                return;
+
+            // Retime the dry signal of all channels to the latency of the active convolvers
+            nDelay              = latency;
+            for (size_t i=0; i<nChannels; ++i)
+                vChannels[i].sDryDelay.set_delay(nDelay);
+            set_latency(nDelay);
+        }
+
+        bool impulse_responses::submit_store_task()
+        {
+            // All convolvers are built with the current settings
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                c->bCommit          = true;
+                c->bEqCommit        = c->bEqBake;
+                memcpy(c->vEqCommit, c->vEqParams, sizeof(c->vEqParams));
+            }
+            nStoreSlot          = nStoreReq;
+            nJobFiles           = (size_t(1) << nFiles) - 1;
+            bPreview            = false;
+            commit_settings();
+
+            if (pExecutor->submit(&sConfigurator))
+            {
+                nStoreReq           = 0;
+                return true;
+            }
+
+            // Submit failed, keep the request pending
+            for (size_t i=0; i<nChannels; ++i)
+                vChannels[i].bCommit    = false;
+            nStoreSlot          = 0;
+
+            return false;
+        }
+
+        void impulse_responses::commit_store()
+        {
+            bank_slot_t *b      = &vBank[nStoreSlot - 1];
+            nBankStatus         = sConfigurator.code();
+
+            if (nBankStatus == STATUS_OK)
+            {
+                // Previous convolvers of the slot are destroyed by the next run of the configurator
+                b->nLatency         = 0;
+                b->nSize            = 0;
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c        = &vChannels[i];
+                    lsp::swap(b->vConv[i], c->pSwap);
+                    b->vEqBaked[i]      = c->bEqCommit;
+
+                    const IRConvolver *cv   = b->vConv[i];
+                    if (cv == NULL)
+                        continue;
+                    b->nLatency         = cv->latency();
+                    b->nSize           += cv->size();
+                }
+                b->nSampleRate      = fSampleRate;
+                b->bUsed            = true;
+
+                // Replace active convolvers if the slot is in use
+                if (nSlot == nStoreSlot)
+                {
+                    for (size_t i=0; i<nChannels; ++i)
+                        activate(&vChannels[i], b->vConv[i], b->vEqBaked[i]);
+                }
+            }
+            else
+                lsp_warn("Error storing bank slot %d: code=%d (%s)", int(nStoreSlot), int(nBankStatus), get_status(nBankStatus));
+
+            for (size_t i=0; i<nChannels; ++i)
+                vChannels[i].bCommit    = false;
+            nStoreSlot          = 0;
+        }
+
+        size_t impulse_responses::bank_size(size_t skip) const
+        {
+            size_t size         = 0;
+            for (size_t i=0; i<meta::impulse_responses_metadata::BANK_SLOTS; ++i)
+            {
+                const bank_slot_t *b    = &vBank[i];
+                if ((b->bUsed) && (i + 1 != skip))
+                    size               += b->nSize;
+            }
+            return size;
+        }
+
+        void impulse_responses::destroy_slot(bank_slot_t *b)
+        {
+            for (size_t i=0; i<IRConvolver::CHANNELS_MAX; ++i)
+                destroy_convolver(b->vConv[i]);
+            b->nSize            = 0;
+            b->bUsed            = false;
+        }
+
+        void impulse_responses::begin_swap(channel_t *c)
+        {
+            c->nPrime           = 0;
+            c->nXFade           = 0;
+
+            // The crossfade is not needed if the previous convolver is silent or has another layout
+            const IRConvolver *cv   = c->pCurr;
+            const IRConvolver *old  = c->pFade;
+            if ((nXFade <= 0) || (cv == NULL) || (old == NULL) || (c->bSleep))
+                return;
+            if ((cv->inputs() != old->inputs()) || (cv->outputs() != old->outputs()))
+                return;
+
+            // The history covers at most PRIME_MAX samples of the input. If the new response
+            // is longer, its tail is still incomplete after priming: keep the previous convolver
+            // audible for longer so the new one is brought in while its tail builds up.
+            size_t fade         = nXFade;
+            const size_t length = cv->length();
+            if (length > nHistFill)
+            {
+                const size_t limit  = dspu::millis_to_samples(fSampleRate, SWAP_FADE_MAX);
+                fade                = lsp_max(fade, lsp_min(length - nHistFill, limit));
+            }
+
+            c->nPrime           = nHistFill;
+            c->nXFade           = fade;
+            c->nXFadeLen        = fade;
+        }
+
+        void impulse_responses::swap_convolver(channel_t *c, float * const *dst, const float * const *src, size_t count)
+        {
+            IRConvolver *cv     = c->pCurr;
+            IRConvolver *old    = c->pFade;
+            const bool shared   = cv->outputs() > 1;
+
+            // The previous convolver keeps producing the output until the crossfade completes
+            old->process(dst, src, count);
+
+            float *out[IRConvolver::CHANNELS_MAX];
+            for (size_t i=0; i<cv->outputs(); ++i)
+                out[i]              = (shared) ? vChannels[i].vSwap : c->vSwap;
+
+            // Prime the new convolver: it processes the history of inputs twice as fast as
+            // the real time and drops the output until it catches up with the current block
+            if (c->nPrime > 0)
+            {
+                const size_t lag    = c->nPrime + count;
+                size_t to_feed      = count + lsp_min(count, c->nPrime);
+                size_t pos          = (nHistPos - lag) & (HISTORY_SIZE - 1);
+
+                while (to_feed > 0)
+                {
+                    const size_t to_do  = lsp_min(lsp_min(to_feed, TMP_BUF_SIZE), HISTORY_SIZE - pos);
+                    const float *in[IRConvolver::CHANNELS_MAX];
+                    for (size_t i=0; i<cv->inputs(); ++i)
+                        in[i]               = (shared) ? &vChannels[i].vHistory[pos] : &c->vHistory[pos];
+
+                    cv->process(out, in, to_do);
+                    pos                 = (pos + to_do) & (HISTORY_SIZE - 1);
+                    to_feed            -= to_do;
+                }
+
+                c->nPrime          -= lsp_min(count, c->nPrime);
+                return;
+            }
+
+            // Crossfade to the new convolver
+            cv->process(out, src, count);
+            const float k       = 1.0f / c->nXFadeLen;
+            const size_t done   = c->nXFadeLen - c->nXFade;
+            for (size_t i=0; i<cv->outputs(); ++i)
+            {
+                float *d            = dst[i];
+                const float *s      = out[i];
+                for (size_t j=0; j<count; ++j)
+                {
+                    const float g       = lsp_min(float(done + j) * k, 1.0f);
+                    d[j]               += (s[j] - d[j]) * g;
+                }
+            }
+            c->nXFade           = (c->nXFade > count) ? c->nXFade - count : 0;
+        }
+
+        void impulse_responses::convolve(channel_t *c, float * const *dst, const float * const *src, size_t count)
+        {
+            IRConvolver *cv     = c->pCurr;
+
+            // Both convolvers are processed while swapping, the silence is not tracked
+            if ((c->nPrime > 0) || (c->nXFade > 0))
+            {
+                swap_convolver(c, dst, src, count);
+                c->nSilence         = 0;
+                return;
+            }
+
+            // Measure the level of the input signal
+            float level         = 0.0f;
+            for (size_t i=0; i<cv->inputs(); ++i)
+                level               = lsp_max(level, dsp::abs_max(src[i], count));
+
+            if (level >= SILENCE_THRESH)
+            {
+                // Wake up, the state of the convolver has been cleared when falling asleep
+                c->nSilence         = 0;
+                c->bSleep           = false;
+            }
+            else
+            {
+                c->nSilence         = lsp_min(c->nSilence + count, cv->length() + 1);
+                if (c->bSleep)
+                {
+                    for (size_t i=0; i<cv->outputs(); ++i)
+                        dsp::fill_zero(dst[i], count);
+                    return;
+                }
+            }
+
+            cv->process(dst, src, count);
+
+            // Fall asleep if the input is silent longer than the response and the output has decayed
+            if (c->nSilence <= cv->length())
+                return;
+            for (size_t i=0; i<cv->outputs(); ++i)
+                if (dsp::abs_max(dst[i], count) >= SILENCE_THRESH)
+                    return;
+
+            cv->clear();
+            c->bSleep           = true;
+        }
+
+        void impulse_responses::output_parameters()
+        {
+            // Update channel activity
+            const IRConvolver *mx   = vChannels[0].pCurr;
+            const size_t shared     = ((mx != NULL) && (mx->outputs() > 1)) ? mx->outputs() : 0;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+                const channel_t *owner  = (i < shared) ? &vChannels[0] : c;
+                c->pActivity->set_value(((c->pCurr != NULL) || (i < shared)) ? 1.0f : 0.0f);
+                c->pSleep->set_value(((owner->pCurr != NULL) && (owner->bSleep)) ? 1.0f : 0.0f);
+            }
+
+            // Hit rate of the resample cache
+            const size_t hits       = atomic_load(&nCacheHits);
+            const size_t lookups    = hits + atomic_load(&nCacheMisses);
+            pCacheHits->set_value((lookups > 0) ? hits * 100.0f / lookups : 0.0f);
+
+            // Estimated CPU saving of the multi-rate tail
+            float saving            = 0.0f;
+            size_t convolvers       = 0;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const IRConvolver *cv   = vChannels[i].pCurr;
+                if (cv == NULL)
+                    continue;
+                saving                 += cv->saving();
+                ++convolvers;
+            }
+            pTailSaving->set_value((convolvers > 0) ? saving * 100.0f / convolvers : 0.0f);
+
+            // Spectral error of the synthesized tail
+            float error             = 0.0f;
+            size_t synthetic        = 0;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const IRConvolver *cv   = vChannels[i].pCurr;
+                if ((cv == NULL) || (!cv->synthetic()))
+                    continue;
+                error                  += cv->synth_error();
+                ++synthetic;
+            }
+            pHybridError->set_value((synthetic > 0) ? error / synthetic : 0.0f);
+
+            // Temporary load of the swap: the primed convolver is processed twice as fast as
+            // the real time, then both convolvers are processed during the crossfade
+            float load              = 0.0f;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const channel_t *c      = &vChannels[i];
+                if (c->nPrime > 0)
+                    load                    = lsp_max(load, 2.0f);
+                else if (c->nXFade > 0)
+                    load                    = lsp_max(load, 1.0f);
+            }
+            pSwapLoad->set_value(load * 100.0f);
+
+            // Diagnostics of reconfiguration: completed and cancelled jobs
+            pJobsDone->set_value(nJobsDone);
+            pJobsCancelled->set_value(nJobsCancelled);
+
+            // Memory usage of the bank, the status of the last store operation and the memory shared between instances
+            pBankUsage->set_value((nBankLimit > 0) ? bank_size(0) * 100.0f / nBankLimit : 0.0f);
+            pBankStatus->set_value(nBankStatus);
+            pSharedMemory->set_value(pRegistry->resident_bytes() / float(1 << 20));
+
+            // Do not output meshes until configuration finishes
+            if (!sConfigurator.idle())
+                return;
+
+            // Update indicators and meshes (if possible)
+            for (size_t i=0; i<nFiles; ++i)
+            {
+                af_descriptor_t *af     = &vFiles[i];
+
+                // Do nothing if loader task is active
+                if (!af->pLoader->idle())
+                    continue;
+
+                // Output information about the file
+                dspu::Sample *active    = vChannels[0].sPlayer.get(i);
+                size_t channels         = (active != NULL) ? active->channels() : 0;
+                channels                = lsp_min(channels, nChannels);
+
+                // Output activity indicator
+                const float duration    = ((af->pOriginal != NULL) || (af->bDeferred)) ? af->fDuration : 0.0f;
+                af->pLength->set_value(duration * 1000.0f);
+                af->pTrimmed->set_value((active != NULL) ? dspu::samples_to_seconds(fSampleRate, active->length()) * 1000.0f : 0.0f);
+                af->pRT60->set_value((active != NULL) ? af->fRT60 * 1000.0f : 0.0f);
+                af->pStatus->set_value(af->nStatus);
+
+                // Store file dump to mesh
+                plug::mesh_t *mesh      = af->pThumbs->buffer<plug::mesh_t>();
+                if ((mesh == NULL) || (!mesh->isEmpty()) || (!af->bSync))
+                    continue;
+
+                if (channels > 0)
+                {
+                    // Copy thumbnails
+                    for (size_t j=0; j<channels; ++j)
+                        dsp::copy(mesh->pvData[j], af->vThumbs[j], meta::impulse_responses_metadata::MESH_SIZE);
+                    mesh->data(channels, meta::impulse_responses_metadata::MESH_SIZE);
+                }
+                else
+                    mesh->data(0, 0);
+                af->bSync           = false;
+            }
+        }
+
+        void impulse_responses::process(size_t samples)
+        {
+            process_loading_tasks();
+            process_configuration_tasks(samples);
+            process_prepare_tasks();
+            process_bank_events();
+            process_gc_events();
+            process_listen_events();
+            perform_convolution(samples);
+            output_parameters();
+        }
+
+        status_t impulse_responses::load(af_descriptor_t *descr)
+        {
+            lsp_trace("descr = %p", descr);
+
+            // Check state
+            if (descr == NULL)
+                return STATUS_UNKNOWN_ERR;
+
+            // Destroy previously loaded sample and all it's resampled copies
+            drop_cache(descr);
+            release_shared(descr->pOriginal);
+            destroy_sample(descr->pCached);
+            descr->sPath.clear();
+            descr->nHash        = 0;
+            descr->bDeferred    = false;
+
+            // Check state
+            if (descr->pFile == NULL)
+                return STATUS_UNKNOWN_ERR;
+
+            // Get path
+            plug::path_t *path = descr->pFile->buffer<plug::path_t>();
+            if (path == NULL)
+                return STATUS_UNKNOWN_ERR;
+
+            // Get file name
+            const char *fname = path->path();
+            if (strlen(fname) <= 0)
+                return STATUS_UNSPECIFIED;
+
+            status_t res = descr->sPath.set(fname);
+            if (res != STATUS_OK)
+                return res;
+
+            // Compute content hash of the file, it is used as a key for sharing data
+            if (IRDiskCache::hash_file(&descr->nHash, fname) != STATUS_OK)
+                descr->nHash        = 0;
+
+            // Lookup the disk cache for already processed data, the file will be decoded only when needed
+            if (bDiskCache)
+            {
+                IRDiskCache::key_t key;
+                IRDiskCache::info_t info;
+                dspu::Sample *s     = NULL;
+
+                if ((make_cache_key(&key, descr)) && (sDiskCache.load(&s, &info, &key) == STATUS_OK))
+                {
+                    lsp_trace("Loaded processed sample %p from disk cache", s);
+                    descr->pCached      = s;
+                    descr->sCacheKey    = key;
+                    descr->fNorm        = info.fNorm;
+                    descr->fDuration    = info.fDuration;
+                    descr->fRT60        = info.fRT60;
+                    descr->bDeferred    = true;
+                    return STATUS_OK;
+                }
+            }
+
+            return decode(descr, fname);
+        }
+
+        status_t impulse_responses::decode(af_descriptor_t *descr, const char *fname)
+        {
+            // Try to use the file already decoded by another instance
+            dspu::Sample *af    = pRegistry->acquire(fname, descr->nHash, 0);
+            lsp_finally { release_shared(af); };
+
+            if (af == NULL)
+            {
+                // Load audio file
+                dspu::Sample *s     = new dspu::Sample();
+                if (s == NULL)
+                    return STATUS_NO_MEM;
+                lsp_trace("Allocated sample %p", s);
+                lsp_finally { destroy_sample(s); };
+
+                // Try to load file
+                float convLengthMaxSeconds = meta::impulse_responses_metadata::CONV_LENGTH_MAX * 0.001f;
+                status_t status = s->load(fname,  convLengthMaxSeconds);
+                if (status != STATUS_OK)
+                {
+                    lsp_trace("load failed: status=%d (%s)", status, get_status(status));
+                    return status;
+                }
+
+                // Share the decoded file with other instances
+                af                  = pRegistry->publish(fname, descr->nHash, 0, s);
+                s                   = NULL;
+                if (af == NULL)
+                    return STATUS_NO_MEM;
+            }
+
+            // Determine the normalizing factor
+            size_t channels         = af->channels();
+            float max = 0.0f;
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                // Determine the maximum amplitude
+                float a_max = dsp::abs_max(af->channel(i), af->samples());
+                if (max < a_max)
+                    max     = a_max;
+            }
+            descr->fNorm    = (max != 0.0f) ? 1.0f / max : 1.0f;
+
+            // File was successfully loaded, pass result to the caller
+            release_shared(descr->pOriginal);
+            lsp::swap(descr->pOriginal, af);
+            descr->bDeferred    = false;
+
+            return STATUS_OK;
+        }
+
+        bool impulse_responses::make_cache_key(IRDiskCache::key_t *key, af_descriptor_t *f)
+        {
+            // Compute content hash of the file if it was not computed yet
+            if (f->nHash == 0)
+            {
+                if (f->sPath.is_empty())
+                    return false;
+                if (IRDiskCache::hash_file(&f->nHash, f->sPath.as_utf8()) != STATUS_OK)
+                {
+                    f->nHash            = 0;
+                    return false;
+                }
+            }
+
+            IRDiskCache::init_key(key);
+            key->nHash          = f->nHash;
+            key->nSampleRate    = fSampleRate;
+            const render_params_t *p = &f->sRender;
+            key->nReverse       = (p->bReverse) ? 1 : 0;
+            key->fPitch         = p->fPitch;
+            key->fHeadCut       = p->fHeadCut;
+            key->fTailCut       = p->fTailCut;
+            key->fFadeIn        = p->fFadeIn;
+            key->fFadeOut       = p->fFadeOut;
+            key->nAutoTrim      = (p->bAutoTrim) ? 1 : 0;
+            key->fTrimLevel     = (p->bAutoTrim) ? p->fTrimLevel : 0.0f;
+
+            return true;
+        }
+
+        void impulse_responses::commit_render_params(af_descriptor_t *f)
+        {
+            // The loader and the configurator work with the snapshot, so parameters may change while they are running
+            render_params_t *p  = &f->sRender;
+            p->fPitch           = f->fPitch;
+            p->fHeadCut         = f->fHeadCut;
+            p->fTailCut         = f->fTailCut;
+            p->fFadeIn          = f->fFadeIn;
+            p->fFadeOut         = f->fFadeOut;
+            p->fTrimLevel       = f->fTrimLevel;
+            p->bReverse         = f->bReverse;
+            p->bAutoTrim        = f->bAutoTrim;
+        }
+
+        void impulse_responses::render_thumbnails(af_descriptor_t *f, const dspu::Sample *s)
+        {
+            const size_t channels   = s->channels();
+            const size_t fsamples   = s->length();
+
+            for (size_t i=0; i<lsp_min(channels, meta::impulse_responses_metadata::TRACKS_MAX); ++i)
+            {
+                const float *src    = s->channel(i);
+                float *dst          = f->vThumbs[i];
+
+                for (size_t k=0; k<meta::impulse_responses_metadata::MESH_SIZE; ++k)
+                {
+                    size_t first    = (k * fsamples) / meta::impulse_responses_metadata::MESH_SIZE;
+                    size_t last     = ((k + 1) * fsamples) / meta::impulse_responses_metadata::MESH_SIZE;
+                    if (first < last)
+                        dst[k]          = dsp::abs_max(&src[first], last - first);
+                    else
+                        dst[k]          = fabs(src[first]);
+                }
+
+                // Normalize graph if possible
+                if (f->fNorm != 1.0f)
+                    dsp::mul_k2(dst, f->fNorm, meta::impulse_responses_metadata::MESH_SIZE);
+            }
+        }
+
+        const dspu::Sample *impulse_responses::get_draft(dspu::Sample **draft, const dspu::Sample *af, size_t sample_rate)
+        {
+            if ((af == NULL) || (af->sample_rate() == sample_rate))
+                return af;
+
+            // Linear interpolation is much faster than the resampling by the windowed sinc
+            const size_t channels   = af->channels();
+            const size_t length     = af->length();
+            const size_t samples    = (uint64_t(length) * sample_rate) / af->sample_rate();
+            dspu::Sample *s     = sArena.acquire_sample(channels, samples);
+            if (s == NULL)
+                return NULL;
+            *draft              = s;
+            s->set_sample_rate(sample_rate);
+
+            const double step       = double(af->sample_rate()) / double(sample_rate);
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *src        = af->channel(i);
+                float *dst              = s->channel(i);
+                for (size_t j=0; j<samples; ++j)
+                {
+                    const double x          = j * step;
+                    const size_t k          = x;
+                    const float a           = (k < length) ? src[k] : 0.0f;
+                    const float b           = (k + 1 < length) ? src[k + 1] : 0.0f;
+                    dst[j]                  = a + (b - a) * float(x - k);
+                }
+            }
+
+            return s;
+        }
+
+        const dspu::Sample *impulse_responses::get_resampled(af_descriptor_t *f, size_t sample_rate)
+        {
+            const dspu::Sample *af  = f->pOriginal;
+            if ((af == NULL) || (af->sample_rate() == sample_rate))
+                return af;
+
+            // Lookup the cache first, files are rendered in parallel
+            const size_t access = atomic_add(&nCacheClock, uatomic_t(1)) + 1;
+            for (size_t i=0; i<RS_CACHE_SIZE; ++i)
+            {
+                rs_cache_t *rc      = &f->vCache[i];
+                if ((rc->pSample != NULL) && (rc->nSampleRate == sample_rate))
+                {
+                    rc->nAccess         = access;
+                    atomic_add(&nCacheHits, uatomic_t(1));
+                    lsp_trace("Resample cache hit: hits=%d, misses=%d", int(nCacheHits), int(nCacheMisses));
+                    return rc->pSample;
+                }
+            }
+
+            // Try to use the copy already resampled by another instance
+            const char *path    = f->sPath.as_utf8();
+            dspu::Sample *s     = pRegistry->acquire(path, f->nHash, sample_rate);
+            lsp_finally { release_shared(s); };
+
+            if (s != NULL)
+            {
+                atomic_add(&nCacheHits, uatomic_t(1));
+                lsp_trace("Resample cache shared hit: hits=%d, misses=%d", int(nCacheHits), int(nCacheMisses));
+            }
+            else
+            {
+                atomic_add(&nCacheMisses, uatomic_t(1));
+                lsp_trace("Resample cache miss: hits=%d, misses=%d", int(nCacheHits), int(nCacheMisses));
+
+                // Copy data of original sample to the new sample and perform resampling
+                dspu::Sample *tmp   = new dspu::Sample();
+                if (tmp == NULL)
+                    return NULL;
+                lsp_trace("Allocated sample %p", tmp);
+                lsp_finally { destroy_sample(tmp); };
+
+                if (tmp->copy(af) != STATUS_OK)
+                {
+                    lsp_warn("Error copying source sample");
+                    return NULL;
+                }
+                if (tmp->resample(sample_rate) != STATUS_OK)
+                {
+                    lsp_warn("Error resampling source sample");
+                    return NULL;
+                }
+
+                // Share the resampled copy with other instances
+                s                   = pRegistry->publish(path, f->nHash, sample_rate, tmp);
+                tmp                 = NULL;
+                if (s == NULL)
+                    return NULL;
+            }
+            const size_t bytes  = s->channels() * s->samples() * sizeof(float);
+
+            // Evict least recently used copies until the new one fits the memory cap
+            while (true)
+            {
+                size_t used         = 0;
+                rs_cache_t *lru     = NULL;
+                for (size_t i=0; i<RS_CACHE_SIZE; ++i)
+                {
+                    rs_cache_t *rc      = &f->vCache[i];
+                    if (rc->pSample == NULL)
+                        continue;
+                    used               += rc->nBytes;
+                    if ((lru == NULL) || (rc->nAccess < lru->nAccess))
+                        lru                 = rc;
+                }
+                if ((lru == NULL) || (used + bytes <= RS_CACHE_BYTES))
+                    break;
+
+                release_shared(lru->pSample);
+                lru->nSampleRate    = 0;
+                lru->nBytes         = 0;
+                lru->nAccess        = 0;
+            }
+
+            // Store the copy in the free slot or replace the least recently used one
+            rs_cache_t *dst     = &f->vCache[0];
+            for (size_t i=0; i<RS_CACHE_SIZE; ++i)
+            {
+                rs_cache_t *rc      = &f->vCache[i];
+                if (rc->pSample == NULL)
+                {
+                    dst                 = rc;
+                    break;
+                }
+                if (rc->nAccess < dst->nAccess)
+                    dst                 = rc;
+            }
+
+            release_shared(dst->pSample);
+            lsp::swap(dst->pSample, s);
+            dst->nSampleRate    = sample_rate;
+            dst->nBytes         = bytes;
+            dst->nAccess        = access;
+
+            return dst->pSample;
+        }
+
+        status_t impulse_responses::reconfigure()
+        {
+            // Convolvers go live after the head has been transformed, the rest is transformed by the pool of threads
+            nImmediate      = dspu::millis_to_samples(fSampleRate, PREPARE_SPAN);
+
+            // Memory released by this job is reused by the next one, the rest is returned to the heap
+            lsp_finally {
+                sArena.trim();
+                lsp_trace("Arena: allocations=%d, reuses=%d", int(sArena.allocs()), int(sArena.reuses()));
+            };
+
+            // Destroy convolvers of cleared slots of the bank
+            for (size_t i=0; i<meta::impulse_responses_metadata::BANK_SLOTS; ++i)
+            {
+                bank_slot_t *b      = &vBank[i];
+                if (!b->bUsed)
+                    destroy_slot(b);
+            }
+
+            // Re-render only files that have been changed, independent files are rendered in parallel.
+            // Render items read only the per-file snapshot and sJob committed at submit time
+            FileRenderer renderer(this);
+            run_batch(&renderer, nFiles);
+            if (renderer.status() != STATUS_OK)
+                return renderer.status();
+
+            // Randomize phase of the convolver
+            uint32_t phase  = seed_addr(this);
+            phase           = ((phase << 16) | (phase >> 16)) & 0x7fffffff;
+            uint32_t step   = 0x80000000 / (nChannels + 1);
+
+            // OK, files have been rendered, now need to commutate, channels are built in parallel
+            ChannelBuilder builder(this, phase, step);
+            run_batch(&builder, nChannels);
+            if (builder.status() != STATUS_OK)
+                return builder.status();
+
+            // Convolvers stored to the bank should fit the memory limit
+            if (nStoreSlot > 0)
+            {
+                size_t size         = bank_size(nStoreSlot);
+                size_t convolvers   = 0;
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    const IRConvolver *cv   = vChannels[i].pSwap;
+                    if (cv == NULL)
+                        continue;
+                    size               += cv->size();
+                    ++convolvers;
+                }
+
+                if ((convolvers <= 0) || (size > nBankLimit))
+                {
+                    for (size_t i=0; i<nChannels; ++i)
+                        destroy_convolver(vChannels[i].pSwap);
+                    return (convolvers <= 0) ? STATUS_NO_DATA : STATUS_OVERFLOW;
+                }
+
+                // Stored convolvers should be complete when the slot is selected
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    IRConvolver *cv     = vChannels[i].pSwap;
+                    while ((cv != NULL) && (!cv->prepared()))
+                    {
+                        if (!cv->prepare(pPool))
+                            return STATUS_NO_MEM;
+                    }
+                }
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t impulse_responses::render_file(af_descriptor_t *f)
+        {
+            if (!f->bCommit)
+                return STATUS_OK;
+            if (cancelled())
+                return STATUS_CANCELLED;
+
+            // Recycle previously processed sample
+            recycle_sample(f->pProcessed);
+            f->nProcessed       = 0;
+
+            // Get sample to process, render parameters are taken from the snapshot only
+            const render_params_t *p = &f->sRender;
+            if ((f->pOriginal == NULL) && (!f->bDeferred))
+                return STATUS_OK;
+
+            // Lookup the disk cache for the processed data
+            IRDiskCache::key_t key;
+            IRDiskCache::info_t info;
+            const bool keyed        = make_cache_key(&key, f);
+            const bool use_cache    = (sJob.bDiskCache) && (keyed);
+            const uint64_t digest   = (keyed) ? IRDiskCache::digest(&key, sizeof(key)) : 0;
+            if (f->pCached != NULL)
+            {
+                if ((use_cache) && (memcmp(&key, &f->sCacheKey, sizeof(key)) == 0))
+                {
+                    render_thumbnails(f, f->pCached);
+                    lsp::swap(f->pProcessed, f->pCached);
+                    f->nProcessed       = digest;
+                    return STATUS_OK;
+                }
+                destroy_sample(f->pCached);
+            }
+            if (use_cache)
+            {
+                dspu::Sample *s     = NULL;
+                if (sDiskCache.load(&s, &info, &key) == STATUS_OK)
+                {
+                    lsp_trace("Loaded processed sample %p from disk cache", s);
+                    f->fDuration        = info.fDuration;
+                    f->fRT60            = info.fRT60;
+                    render_thumbnails(f, s);
+                    lsp::swap(f->pProcessed, s);
+                    f->nProcessed       = digest;
+                    return STATUS_OK;
+                }
+            }
+
+            // Decode the file if decoding has been deferred
+            if (f->pOriginal == NULL)
+            {
+                status_t res = decode(f, f->sPath.as_utf8());
+                if (res != STATUS_OK)
+                {
+                    lsp_warn("Error decoding deferred file: code=%d (%s)", int(res), get_status(res));
+                    return STATUS_OK;
+                }
+            }
+
+            // Obtain the resampled copy of the original sample, the preview uses the fast interpolation
+            const size_t sample_rate_dst  = fSampleRate * dspu::semitones_to_frequency_shift(-p->fPitch);
+            dspu::Sample *draft     = NULL;
+            lsp_finally { recycle_sample(draft); };
+            const dspu::Sample *af  = (bPreview) ? get_draft(&draft, f->pOriginal, sample_rate_dst) : get_resampled(f, sample_rate_dst);
+            if (af == NULL)
+                return STATUS_NO_MEM;
+            if (cancelled())
+                return STATUS_CANCELLED;
+
+            // Obtain new sample parameters
+            const ssize_t flen  = af->samples();
+            size_t channels     = lsp_min(af->channels(), meta::impulse_responses_metadata::TRUE_STEREO_TRACKS);
+            size_t head_cut     = dspu::millis_to_samples(fSampleRate, p->fHeadCut);
+            size_t tail_cut     = dspu::millis_to_samples(fSampleRate, p->fTailCut);
+            ssize_t fsamples    = flen - head_cut - tail_cut;
+            if (fsamples <= 0)
+            {
+                for (size_t j=0; j<meta::impulse_responses_metadata::TRACKS_MAX; ++j)
+                    dsp::fill_zero(f->vThumbs[j], meta::impulse_responses_metadata::MESH_SIZE);
+                f->fRT60            = 0.0f;
+                return STATUS_OK;
+            }
+
+            // The preview keeps only the head of the impulse response
+            const ssize_t full  = fsamples;
+            if (bPreview)
+                fsamples            = lsp_min(fsamples, ssize_t(dspu::millis_to_samples(fSampleRate, PREVIEW_LENGTH)));
+
+            // Allocate only the part of the sample left after cutting, cut, reverse and fade-in
+            // are applied while copying the data. The sample released by the previous render is reused
+            dspu::Sample *s     = sArena.acquire_sample(channels, fsamples);
+            if (s == NULL)
+                return STATUS_NO_MEM;
+            lsp_trace("Allocated sample %p", s);
+            lsp_finally { recycle_sample(s); };
+
+            // Copy data to temporary buffer and apply fade-in
+            for (size_t i=0; i<channels; ++i)
+            {
+                float *dst = s->channel(i);
+                const float *src = af->channel(i);
+
+                if (p->bReverse)
+                {
+                    dsp::reverse2(dst, &src[tail_cut + full - fsamples], fsamples);
+                    dspu::fade_in(dst, dst, dspu::millis_to_samples(fSampleRate, p->fFadeIn), fsamples);
+                }
+                else
+                    dspu::fade_in(dst, &src[head_cut], dspu::millis_to_samples(fSampleRate, p->fFadeIn), fsamples);
+            }
+
+            // Analyze the energy decay and trim the tail which is below the threshold
+            if (!bPreview)
+            {
+                ir_decay_t decay;
+                analyze_decay(&decay, s, p->fTrimLevel, fSampleRate);
+                f->fRT60            = decay.fRT60;
+                if ((p->bAutoTrim) && (decay.nLength < size_t(fsamples)))
+                {
+                    fsamples            = decay.nLength;
+                    s->set_length(fsamples);
+                }
+            }
+
+            // Apply fade-out to the final length of the sample
+            for (size_t i=0; i<channels; ++i)
+            {
+                float *dst = s->channel(i);
+                dspu::fade_out(dst, dst, dspu::millis_to_samples(fSampleRate, p->fFadeOut), fsamples);
+            }
+
+            // The preview does not update thumbnails and does not get to the disk cache
+            if (bPreview)
+            {
+                lsp::swap(f->pProcessed, s);
+                return STATUS_OK;
+            }
+
+            // Now render thumbnails
+            render_thumbnails(f, s);
+            f->fDuration        = dspu::samples_to_seconds(fSampleRate, flen);
+
+            // Store processed data to the disk cache
+            if (use_cache)
+            {
+                info.fNorm          = f->fNorm;
+                info.fDuration      = f->fDuration;
+                info.fRT60          = f->fRT60;
+                info.nPadding       = 0;
+                status_t res        = sDiskCache.store(s, &info, &key);
+                if (res != STATUS_OK)
+                    lsp_warn("Error storing processed sample to disk cache: code=%d (%s)", int(res), get_status(res));
+            }
+
+            // Commit sample to the processed list
+            lsp::swap(f->pProcessed, s);
+            f->nProcessed       = digest;
+
+            return STATUS_OK;
+        }
+
+        status_t impulse_responses::build_channel(size_t i, uint32_t phase, uint32_t step)
+        {
+            channel_t *c    = &vChannels[i];
+
+            // Destroy previously allocated convolver
+            destroy_convolver(c->pSwap);
+            if (!c->bCommit)
+                return STATUS_OK;
+            if (cancelled())
+                return STATUS_CANCELLED;
+
+            // The shared convolver is owned by the first channel
+            if (sJob.bMatrix)
+            {
+                if (i > 0)
+                    return STATUS_OK;
+                const float c_phase = float(phase & 0x7fffffff)/float(0x80000000);
+                return (sJob.bTrueStereo) ? create_true_stereo(c, c_phase) : create_mono_stereo(c, c_phase);
+            }
+
+            // Check that routing has changed
+            size_t ch   = c->nSource;
+            if (ch == 0)
+                return STATUS_OK;
+            --ch;
+
+            // Apply new routing
+            size_t track    = ch % meta::impulse_responses_metadata::TRACKS_MAX;
+            size_t file     = ch / meta::impulse_responses_metadata::TRACKS_MAX;
+            if (file >= nFiles)
+                return STATUS_OK;
+
+            // Analyze sample: use the re-rendered one or the one that is currently in use
+            const dspu::Sample *s   = get_committed(&vFiles[file]);
+            if ((s == NULL) || (s->channels() <= track))
+                return STATUS_OK;
+
+            // The morphing convolver is created if the other file provides the same track
+            if (sJob.bMorph)
+            {
+                status_t res    = create_morph(c, s, file, track, float((phase + i*step) & 0x7fffffff)/float(0x80000000));
+                if (res != STATUS_OK)
+                    return res;
+                if (c->pSwap != NULL)
+                    return STATUS_OK;
+            }
+
+            // Prepare the kernel and the kernel of the multi-rate tail or the synthesized tail
+            IRKernel *k     = NULL;
+            lsp_finally { destroy_kernel(k); };
+            IRKernel *tail  = NULL;
+            lsp_finally { destroy_kernel(tail); };
+            const size_t paths  = IRConvolver::CHANNELS_MAX * IRConvolver::CHANNELS_MAX;
+            IRFdn *synth[paths];
+            for (size_t j=0; j<paths; ++j)
+                synth[j]        = NULL;
+            lsp_finally {
+                for (size_t j=0; j<paths; ++j)
+                    destroy_synth(synth[j]);
+            };
+            const bool hybrid   = use_hybrid(s->length());
+            const bool split    = (!hybrid) && (use_tail(s->length()));
+            const float *ir     = s->channel(track);
+            status_t res        = create_kernel(&k, (split) ? &tail : NULL, (hybrid) ? &synth[0] : NULL, c,
+                committed_digest(&vFiles[file]), track, ir, s->length(), s->length(), IRKernel::silence(ir, s->length()));
+            if (res != STATUS_OK)
+                return res;
+
+            // Now we can create convolver
+            IRConvolver *cv = new IRConvolver(&sArena);
+            if (cv == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_convolver(cv); };
+
+            // Initialize convolver, it takes references to kernels
+            IRWorker *worker    = (sWorker.active()) ? &sWorker : NULL;
+            if (!cv->init(k, tail, sJob.nTailFactor, float((phase + i*step) & 0x7fffffff)/float(0x80000000), worker))
+                return STATUS_NO_MEM;
+            k               = NULL;
+            tail            = NULL;
+            cv->set_synth(synth);
+            for (size_t j=0; j<paths; ++j)
+                synth[j]        = NULL;
+
+            // Commit convolver
+            lsp::swap(c->pSwap, cv);
+
+            return STATUS_OK;
+        }
+
+        status_t impulse_responses::create_morph(channel_t *c, const dspu::Sample *s, size_t file, size_t track, float phase)
+        {
+            const dspu::Sample *m   = get_committed(&vFiles[file ^ 1]);
+            if ((m == NULL) || (m->channels() <= track))
+                return STATUS_OK;
+
+            // Both kernels should have the same layout, the multi-rate and the synthesized
+            // tails can not be morphed and are not applied
+            const float *ir     = s->channel(track);
+            const float *mr     = m->channel(track);
+            size_t span         = lsp_max(s->length(), m->length());
+            const size_t silence= lsp_min(IRKernel::silence(ir, s->length()), IRKernel::silence(mr, m->length()));
+            if (c->bEqCommit)
+                span               += eq_bake_tail();
+
+            IRKernel *k         = NULL;
+            lsp_finally { destroy_kernel(k); };
+            IRKernel *km        = NULL;
+            lsp_finally { destroy_kernel(km); };
+
+            status_t res        = create_kernel(&k, NULL, NULL, c, committed_digest(&vFiles[file]), track, ir, s->length(), span, silence);
+            if (res != STATUS_OK)
+                return res;
+            res                 = create_kernel(&km, NULL, NULL, c, committed_digest(&vFiles[file ^ 1]), track, mr, m->length(), span, silence);
+            if (res != STATUS_OK)
+                return res;
+
+            // Create convolver, it takes references to kernels
+            IRConvolver *cv     = new IRConvolver(&sArena);
+            if (cv == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_convolver(cv); };
+
+            IRWorker *worker    = (sWorker.active()) ? &sWorker : NULL;
+            if (!cv->init_morph(k, km, phase, worker))
+                return STATUS_NO_MEM;
+            k                   = NULL;
+            km                  = NULL;
+
+            // Commit convolver
+            lsp::swap(c->pSwap, cv);
+            return STATUS_OK;
+        }
+
+        status_t impulse_responses::create_true_stereo(channel_t *c, float phase)
+        {
+            const size_t paths  = IRConvolver::CHANNELS_MAX * IRConvolver::CHANNELS_MAX;
+            const dspu::Sample *samples[paths];
+            size_t tracks[paths];
+            uint64_t digests[paths];
+
+            // Map tracks to paths: four-track file contains all paths, otherwise the first
+            // file contains paths of the left input and the second file - of the right input
+            const dspu::Sample *s   = get_committed(&vFiles[0]);
+            if ((s != NULL) && (s->channels() >= meta::impulse_responses_metadata::TRUE_STEREO_TRACKS))
             {
-                af_descriptor_t *f  = &vFiles[i];
-
-                // Need to start audio preview playback?
-                if (f->sListen.pending())
+                for (size_t i=0; i<paths; ++i)
                 {
-                    lsp_trace("Submitted listen toggle");
-                    dspu::Sample *s = vChannels[0].sPlayer.get(i);
-                    const size_t n_c = (s != NULL) ? s->channels() : 0;
-                    if (n_c > 0)
-                    {
-                        for (size_t j=0; j<nChannels; ++j)
-                        {
-                            channel_t *c = &vChannels[j];
-                            ps.set_channel(i, j % n_c);
-                            ps.set_playback(0, 0, GAIN_AMP_0_DB);
-
-                            c->vPlaybacks[i].cancel(fadeout, 0);
-                            c->vPlaybacks[i] = c->sPlayer.play(&ps);
-                        }
-                    }
-                    f->sListen.commit();
+                    samples[i]          = s;
+                    tracks[i]           = i;
+                    digests[i]          = committed_digest(&vFiles[0]);
                 }
-
-                // Need to cancel audio preview playback?
-                if (f->sStop.pending())
+            }
+            else
+            {
+                for (size_t i=0; i<IRConvolver::CHANNELS_MAX; ++i)
                 {
-                    for (size_t j=0; j<nChannels; ++j)
+                    s                   = (i < nFiles) ? get_committed(&vFiles[i]) : NULL;
+                    for (size_t j=0; j<IRConvolver::CHANNELS_MAX; ++j)
                     {
-                        channel_t *c = &vChannels[j];
-                        c->vPlaybacks[i].cancel(fadeout, 0);
+                        const size_t k      = i * IRConvolver::CHANNELS_MAX + j;
+                        samples[k]          = s;
+                        tracks[k]           = (s != NULL) ? lsp_min(j, s->channels() - 1) : 0;
+                        digests[k]          = (s != NULL) ? committed_digest(&vFiles[i]) : 0;
                     }
-                    f->sStop.commit();
                 }
             }
+
+            const size_t n      = lsp_min(nChannels, IRConvolver::CHANNELS_MAX);
+            return create_matrix(c, samples, tracks, digests, n, n, phase);
         }
 
-        void impulse_responses::perform_convolution(size_t samples)
+        status_t impulse_responses::create_mono_stereo(channel_t *c, float phase)
         {
-            // Get pointers to data channels
-            for (size_t i=0; i<nChannels; ++i)
-            {
-                channel_t *c    = &vChannels[i];
-
-                c->vIn          = c->pIn->buffer<float>();
-                c->vOut         = c->pOut->buffer<float>();
-            }
+            const size_t outputs    = lsp_min(nChannels, IRConvolver::CHANNELS_MAX);
+            const dspu::Sample *samples[IRConvolver::CHANNELS_MAX];
+            size_t tracks[IRConvolver::CHANNELS_MAX];
+            uint64_t digests[IRConvolver::CHANNELS_MAX];
 
-            // Process samples
-            while (samples > 0)
+            // Each output is routed to the track selected by the source of the channel
+            for (size_t i=0; i<outputs; ++i)
             {
-                size_t to_do        = TMP_BUF_SIZE;
-                if (to_do > samples)
-                    to_do               = samples;
-
-                for (size_t i=0; i<nChannels; ++i)
-                {
-                    channel_t *c    = &vChannels[i];
+                samples[i]          = NULL;
+                tracks[i]           = 0;
+                digests[i]          = 0;
 
-                    // Do processing
-                    if (c->pCurr != NULL)
-                        c->pCurr->process(c->vBuffer, c->vIn, to_do);
-                    else
-                        dsp::fill_zero(c->vBuffer, to_do);
-                    c->sEqualizer.process(c->vBuffer, c->vBuffer, to_do); // Process wet signal with equalizer
-                    c->sDelay.process(c->vBuffer, c->vBuffer, to_do);
-                    dsp::mix2(c->vBuffer, c->vIn, c->fWetGain, c->fDryGain, to_do);
-                    c->sPlayer.process(c->vBuffer, c->vBuffer, to_do);
-                    c->sBypass.process(c->vOut, c->vIn, c->vBuffer, to_do);
+                const size_t source = vChannels[i].nSource;
+                if (source == 0)
+                    continue;
 
-                    // Update pointers
-                    c->vIn             += to_do;
-                    c->vOut            += to_do;
-                }
+                const size_t track  = (source - 1) % meta::impulse_responses_metadata::TRACKS_MAX;
+                const size_t file   = (source - 1) / meta::impulse_responses_metadata::TRACKS_MAX;
+                const dspu::Sample *s   = (file < nFiles) ? get_committed(&vFiles[file]) : NULL;
+                if ((s == NULL) || (s->channels() <= track))
+                    continue;
 
-                samples            -= to_do;
+                samples[i]          = s;
+                tracks[i]           = track;
+                digests[i]          = committed_digest(&vFiles[file]);
             }
+
+            return create_matrix(c, samples, tracks, digests, 1, outputs, phase);
         }
 
-        void impulse_responses::output_parameters()
+        status_t impulse_responses::create_matrix(
+            channel_t *c, const dspu::Sample * const *samples, const size_t *tracks, const uint64_t *digests,
+            size_t inputs, size_t outputs, float phase)
         {
-            // Update channel activity
-            for (size_t i=0; i<nChannels; ++i)
-            {
-                channel_t *c            = &vChannels[i];
-                c->pActivity->set_value((c->pCurr != NULL) ? 1.0f : 0.0f);
-            }
+            const size_t paths  = IRConvolver::CHANNELS_MAX * IRConvolver::CHANNELS_MAX;
 
-            // Do not output meshes until configuration finishes
-            if (!sConfigurator.idle())
-                return;
+            // All kernels should have the same layout, so the span and the leading silence are common
+            size_t span         = 0;
+            size_t silence      = SIZE_MAX;
+            for (size_t i=0; i<inputs; ++i)
+                for (size_t j=0; j<outputs; ++j)
+                {
+                    const size_t k          = i * IRConvolver::CHANNELS_MAX + j;
+                    const dspu::Sample *s   = samples[k];
+                    if (s == NULL)
+                        continue;
+                    span                    = lsp_max(span, s->length());
+                    silence                 = lsp_min(silence, IRKernel::silence(s->channel(tracks[k]), s->length()));
+                }
+            if (span <= 0)
+                return STATUS_OK;
 
-            // Update indicators and meshes (if possible)
-            for (size_t i=0; i<nChannels; ++i)
+            // Reserve space for the tail of the baked equalizer
+            for (size_t j=0; j<outputs; ++j)
+                if (vChannels[j].bEqCommit)
+                {
+                    span                    += eq_bake_tail();
+                    break;
+                }
+
+            // Prepare kernels, the path from input i to output j has index i * CHANNELS_MAX + j
+            const bool hybrid   = use_hybrid(span);
+            const bool split    = (!hybrid) && (use_tail(span));
+            IRKernel *kernels[paths];
+            IRKernel *tails[paths];
+            IRFdn *synth[paths];
+            for (size_t i=0; i<paths; ++i)
             {
-                af_descriptor_t *af     = &vFiles[i];
+                kernels[i]          = NULL;
+                tails[i]            = NULL;
+                synth[i]            = NULL;
+            }
+            lsp_finally {
+                for (size_t i=0; i<paths; ++i)
+                {
+                    destroy_kernel(kernels[i]);
+                    destroy_kernel(tails[i]);
+                    destroy_synth(synth[i]);
+                }
+            };
 
-                // Do nothing if loader task is active
-                if (!af->pLoader->idle())
-                    continue;
+            for (size_t i=0; i<inputs; ++i)
+                for (size_t j=0; j<outputs; ++j)
+                {
+                    const size_t k          = i * IRConvolver::CHANNELS_MAX + j;
+                    const dspu::Sample *s   = samples[k];
+                    if (s == NULL)
+                        continue;
+                    if (cancelled())
+                        return STATUS_CANCELLED;
+
+                    status_t res        = create_kernel(&kernels[k], (split) ? &tails[k] : NULL, (hybrid) ? &synth[k] : NULL,
+                        &vChannels[j], digests[k], tracks[k], s->channel(tracks[k]), s->length(), span, silence);
+                    if (res != STATUS_OK)
+                        return res;
+                }
 
-                // Output information about the file
-                dspu::Sample *active    = vChannels[0].sPlayer.get(i);
-                size_t channels         = (active != NULL) ? active->channels() : 0;
-                channels                = lsp_min(channels, nChannels);
+            // Create convolver, it takes references to kernels
+            IRConvolver *cv     = new IRConvolver(&sArena);
+            if (cv == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_convolver(cv); };
 
-                // Output activity indicator
-                const float duration    = (af->pOriginal != NULL) ? af->fDuration : 0.0f;
-                af->pLength->set_value(duration * 1000.0f);
-                af->pStatus->set_value(af->nStatus);
+            IRWorker *worker    = (sWorker.active()) ? &sWorker : NULL;
+            if (!cv->init(kernels, (split) ? tails : NULL, sJob.nTailFactor, inputs, outputs, phase, worker))
+                return STATUS_NO_MEM;
+            for (size_t i=0; i<paths; ++i)
+            {
+                kernels[i]          = NULL;
+                tails[i]            = NULL;
+            }
+            cv->set_synth(synth);
+            for (size_t i=0; i<paths; ++i)
+                synth[i]            = NULL;
 
-                // Store file dump to mesh
-                plug::mesh_t *mesh      = af->pThumbs->buffer<plug::mesh_t>();
-                if ((mesh == NULL) || (!mesh->isEmpty()) || (!af->bSync))
-                    continue;
+            // Commit convolver
+            lsp::swap(c->pSwap, cv);
 
-                if (channels > 0)
+            return STATUS_OK;
+        }
+
+        bool impulse_responses::make_kernel_key(IRRegistry::kernel_key_t *key, const channel_t *c,
+            uint64_t digest, size_t track, size_t span, size_t silence, bool split, bool tail) const
+        {
+            // The processed sample without digest is not shared
+            if (digest == 0)
+                return false;
+
+            // Zero all bytes including padding because parameters are hashed as a plain memory
+            kernel_params_t p;
+            memset(&p, 0, sizeof(p));
+            p.nDigest           = digest;
+            p.nTrack            = track;
+            p.nSpan             = span;
+            p.nSilence          = silence;
+            p.nImmediate        = nImmediate;
+            p.nFactor           = (split) ? sJob.nTailFactor : 0;
+            p.fSplit            = (split) ? sJob.fTailSplit : 0.0f;
+            p.nPart             = (tail) ? 1 : 0;
+            p.nEqBake           = (c->bEqCommit) ? 1 : 0;
+            if (c->bEqCommit)
+            {
+                for (size_t i=0; i<meta::impulse_responses_metadata::EQ_BANDS + 2; ++i)
                 {
-                    // Copy thumbnails
-                    for (size_t j=0; j<channels; ++j)
-                        dsp::copy(mesh->pvData[j], af->vThumbs[j], meta::impulse_responses_metadata::MESH_SIZE);
-                    mesh->data(channels, meta::impulse_responses_metadata::MESH_SIZE);
+                    const dspu::filter_params_t *fp = &c->vEqCommit[i];
+                    eq_band_t *b        = &p.vEq[i];
+                    b->nType            = fp->nType;
+                    b->nSlope           = fp->nSlope;
+                    b->fFreq            = fp->fFreq;
+                    b->fFreq2           = fp->fFreq2;
+                    b->fGain            = fp->fGain;
+                    b->fQuality         = fp->fQuality;
                 }
-                else
-                    mesh->data(0, 0);
-                af->bSync           = false;
             }
+
+            key->nHash          = IRDiskCache::digest(&p, sizeof(p));
+            key->nSampleRate    = fSampleRate;
+            key->nRank          = sJob.nRank;
+            key->nLatency       = sJob.nLatency;
+
+            return true;
         }
 
-        void impulse_responses::process(size_t samples)
+        uint64_t impulse_responses::committed_digest(const af_descriptor_t *f)
         {
-            process_loading_tasks();
-            process_configuration_tasks();
-            process_gc_events();
-            process_listen_events();
-            perform_convolution(samples);
-            output_parameters();
+            if (get_committed(f) == NULL)
+                return 0;
+            return (f->bCommit) ? f->nProcessed : f->nActive;
         }
 
-        status_t impulse_responses::load(af_descriptor_t *descr)
+        status_t impulse_responses::create_kernel(IRKernel **k, IRKernel **tail, IRFdn **synth, const channel_t *c,
+            uint64_t digest, size_t track, const float *ir, size_t length, size_t span, size_t silence)
         {
-            lsp_trace("descr = %p", descr);
-
-            // Check state
-            if (descr == NULL)
-                return STATUS_UNKNOWN_ERR;
-
-            // Destroy previously loaded sample
-            destroy_sample(descr->pOriginal);
-
-            // Check state
-            if (descr->pFile == NULL)
-                return STATUS_UNKNOWN_ERR;
-
-            // Get path
-            plug::path_t *path = descr->pFile->buffer<plug::path_t>();
-            if (path == NULL)
-                return STATUS_UNKNOWN_ERR;
-
-            // Get file name
-            const char *fname = path->path();
-            if (strlen(fname) <= 0)
-                return STATUS_UNSPECIFIED;
+            // Kernels with the synthesized tail are not shared since the network is fitted together with the kernel
+            IRRegistry::kernel_key_t key, t_key;
+            const bool split    = tail != NULL;
+            const bool shared   = (synth == NULL) &&
+                (make_kernel_key(&key, c, digest, track, span, silence, split, false)) &&
+                ((!split) || (make_kernel_key(&t_key, c, digest, track, span, silence, split, true)));
+
+            // Use kernels already built by this or another instance, or prepared kernels from the disk cache
+            if (shared)
+            {
+                *k                  = acquire_kernel(&key);
+                if (split)
+                    *tail               = acquire_kernel(&t_key);
+                if ((*k != NULL) && ((!split) || (*tail != NULL)))
+                    return STATUS_OK;
+                destroy_kernel(*k);
+                if (split)
+                    destroy_kernel(*tail);
+            }
 
-            // Load audio file
-            dspu::Sample *af    = new dspu::Sample();
-            if (af == NULL)
+            // Shared kernels can outlive the instance, so they are not allocated in the arena
+            IRArena *arena      = (shared) ? NULL : &sArena;
+            *k                  = new IRKernel(arena);
+            if (*k == NULL)
                 return STATUS_NO_MEM;
-            lsp_trace("Allocated sample %p", af);
-            lsp_finally { destroy_sample(af); };
-
-            // Try to load file
-            float convLengthMaxSeconds = meta::impulse_responses_metadata::CONV_LENGTH_MAX * 0.001f;
-            status_t status = af->load(fname,  convLengthMaxSeconds);
-            if (status != STATUS_OK)
+            if (split)
+            {
+                *tail               = new IRKernel(arena);
+                if (*tail == NULL)
+                    return STATUS_NO_MEM;
+            }
+            if (synth != NULL)
             {
-                lsp_trace("load failed: status=%d (%s)", status, get_status(status));
-                return status;
+                *synth              = new IRFdn();
+                if (*synth == NULL)
+                    return STATUS_NO_MEM;
             }
 
-            // Determine the normalizing factor
-            size_t channels         = af->channels();
-            float max = 0.0f;
+            status_t res        = init_kernel(*k, (split) ? *tail : NULL, (synth != NULL) ? *synth : NULL, c, ir, length, span, silence);
+            if (res != STATUS_OK)
+                return res;
+            if ((synth != NULL) && ((*synth)->length() <= 0))
+                destroy_synth(*synth);
 
-            for (size_t i=0; i<channels; ++i)
+            // Publish kernels, the kernel published by another instance in the meantime replaces this one
+            if (shared)
             {
-                // Determine the maximum amplitude
-                float a_max = dsp::abs_max(af->channel(i), af->samples());
-                if (max < a_max)
-                    max     = a_max;
+                *k                  = publish_kernel(&key, *k);
+                if (split)
+                    *tail               = publish_kernel(&t_key, *tail);
             }
-            descr->fNorm    = (max != 0.0f) ? 1.0f / max : 1.0f;
-
-            // File was successfully loaded, pass result to the caller
-            lsp::swap(descr->pOriginal, af);
 
             return STATUS_OK;
         }
 
-        status_t impulse_responses::reconfigure()
+        IRKernel *impulse_responses::acquire_kernel(const IRRegistry::kernel_key_t *key)
         {
-            // Re-render all files
-            for (size_t i=0; i<nChannels; ++i)
-            {
-                // Get audio file
-                af_descriptor_t *f      = &vFiles[i];
+            IRKernel *k         = pRegistry->acquire_kernel(key);
+            if ((k != NULL) || (!sJob.bDiskCache))
+                return k;
 
-                // Destroy previously processed sample
-                destroy_sample(f->pProcessed);
-
-                // Get sample to process
-                const dspu::Sample *af  = f->pOriginal;
-                if (af == NULL)
-                    continue;
+            // The kernel loaded from the disk cache is prepared, all levels are ready
+            if (sDiskCache.load_kernel(&k, key) != STATUS_OK)
+                return NULL;
+            lsp_trace("Loaded kernel %p from disk cache", k);
 
-                // Copy data of original sample to temporary sample and perform resampling if needed
-                dspu::Sample temp;
-                const size_t sample_rate_dst  = fSampleRate * dspu::semitones_to_frequency_shift(-f->fPitch);
-                if (sample_rate_dst != af->sample_rate())
-                {
-                    if (temp.copy(af) != STATUS_OK)
-                    {
-                        lsp_warn("Error copying source sample");
-                        return STATUS_NO_MEM;
-                    }
-                    if (temp.resample(sample_rate_dst) != STATUS_OK)
-                    {
-                        lsp_warn("Error resampling source sample");
-                        return STATUS_NO_MEM;
-                    }
+            return pRegistry->publish_kernel(key, k);
+        }
 
-                    af          = &temp;
-                }
+        IRKernel *impulse_responses::publish_kernel(const IRRegistry::kernel_key_t *key, IRKernel *k)
+        {
+            IRKernel *pk        = pRegistry->publish_kernel(key, k);
 
-                // Allocate new sample
-                dspu::Sample *s     = new dspu::Sample();
-                if (s == NULL)
-                    return STATUS_NO_MEM;
-                lsp_trace("Allocated sample %p", s);
-                lsp_finally { destroy_sample(s); };
+            // Only the instance which has built the kernel stores it to the disk cache
+            if ((pk == k) && (sJob.bDiskCache))
+                queue_kernel(pk, key);
 
-                // Obtain new sample parameters
-                const ssize_t flen  = af->samples();
-                size_t channels     = lsp_min(af->channels(), meta::impulse_responses_metadata::TRACKS_MAX);
-                size_t head_cut     = dspu::millis_to_samples(fSampleRate, f->fHeadCut);
-                size_t tail_cut     = dspu::millis_to_samples(fSampleRate, f->fTailCut);
-                ssize_t fsamples    = flen - head_cut - tail_cut;
-                if (fsamples <= 0)
-                {
-                    for (size_t j=0; j<channels; ++j)
-                        dsp::fill_zero(f->vThumbs[j], meta::impulse_responses_metadata::MESH_SIZE);
-                    s->set_length(0);
-                    continue;
-                }
+            return pk;
+        }
 
-                // Now ensure that we have enough space for sample
-                if (!s->init(channels, flen, fsamples))
-                    return STATUS_NO_MEM;
+        status_t impulse_responses::init_kernel(IRKernel *k, IRKernel *tail, IRFdn *synth, const channel_t *c,
+            const float *ir, size_t length, size_t span, size_t silence)
+        {
+            if (!c->bEqCommit)
+                return build_kernel(k, tail, synth, ir, length, span, silence);
 
-                // Copy data to temporary buffer and apply fading
-                for (size_t i=0; i<channels; ++i)
-                {
-                    float *dst = s->channel(i);
-                    const float *src = af->channel(i);
+            // Allocate buffer for the impulse response and the tail of the equalizer
+            const size_t count  = length + eq_bake_tail();
+            float *buf          = reinterpret_cast<float *>(IRArena::acquire(&sArena, count * sizeof(float)));
+            if (buf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { IRArena::release(&sArena, reinterpret_cast<uint8_t *>(buf)); };
 
-                    // Copy sample data and apply fading
-                    if (f->bReverse)
-                    {
-                        dsp::reverse2(dst, &src[tail_cut], fsamples);
-                        dspu::fade_in(dst, dst, dspu::millis_to_samples(fSampleRate, f->fFadeIn), fsamples);
-                    }
-                    else
-                        dspu::fade_in(dst, &src[head_cut], dspu::millis_to_samples(fSampleRate, f->fFadeIn), fsamples);
-                    dspu::fade_out(dst, dst, dspu::millis_to_samples(fSampleRate, f->fFadeOut), fsamples);
+            dsp::copy(buf, ir, length);
+            dsp::fill_zero(&buf[length], count - length);
 
-                    // Now render thumbnail
-                    src                 = dst;
-                    dst                 = f->vThumbs[i];
-                    for (size_t k=0; k<meta::impulse_responses_metadata::MESH_SIZE; ++k)
-                    {
-                        size_t first    = (k * fsamples) / meta::impulse_responses_metadata::MESH_SIZE;
-                        size_t last     = ((k + 1) * fsamples) / meta::impulse_responses_metadata::MESH_SIZE;
-                        if (first < last)
-                            dst[k]          = dsp::abs_max(&src[first], last - first);
-                        else
-                            dst[k]          = fabs(src[first]);
-                    }
+            // Apply the wet equalizer to the impulse response
+            dspu::Equalizer eq;
+            lsp_finally { eq.destroy(); };
+            const size_t n_filters  = meta::impulse_responses_metadata::EQ_BANDS + 2;
+            if (!eq.init(n_filters, CONV_RANK))
+                return STATUS_NO_MEM;
+            eq.set_sample_rate(fSampleRate);
+            eq.set_mode(dspu::EQM_IIR);
+            for (size_t i=0; i<n_filters; ++i)
+                eq.set_params(i, &c->vEqCommit[i]);
+            eq.process(buf, buf, count);
+
+            // Cut the inaudible part of the tail
+            const float thresh  = dsp::abs_max(buf, count) * EQ_BAKE_THRESH;
+            size_t baked        = count;
+            while ((baked > length) && (fabsf(buf[baked - 1]) <= thresh))
+                --baked;
+
+            return build_kernel(k, tail, synth, buf, baked, lsp_max(span, baked), silence);
+        }
 
-                    // Normalize graph if possible
-                    if (f->fNorm != 1.0f)
-                        dsp::mul_k2(dst, f->fNorm, meta::impulse_responses_metadata::MESH_SIZE);
-                }
+        status_t impulse_responses::build_kernel(IRKernel *k, IRKernel *tail, IRFdn *synth,
+            const float *ir, size_t length, size_t span, size_t silence)
+        {
+            if (synth != NULL)
+                return init_hybrid_kernel(k, synth, ir, length, silence);
+            if (tail != NULL)
+                return init_split_kernel(k, tail, ir, length, span, silence);
+            return (k->init(ir, length, span, silence, sJob.nRank, sJob.nLatency, nImmediate)) ? STATUS_OK : STATUS_NO_MEM;
+        }
 
-                // Commit sample to the processed list
-                lsp::swap(f->pProcessed, s);
-                f->fDuration        = dspu::samples_to_seconds(fSampleRate, flen);
-            }
+        size_t impulse_responses::tail_split() const
+        {
+            // The crossover point should leave space for the delay of resampling filters
+            const size_t split  = dspu::millis_to_samples(fSampleRate, sJob.fTailSplit);
+            return lsp_max(split, IRResampler::delay(sJob.nTailFactor) * 4);
+        }
 
-            // Randomize phase of the convolver
-            uint32_t phase  = seed_addr(this);
-            phase           = ((phase << 16) | (phase >> 16)) & 0x7fffffff;
-            uint32_t step   = 0x80000000 / (nChannels + 1);
+        bool impulse_responses::use_tail(size_t span) const
+        {
+            return (sJob.nTailFactor > 0) && (span > tail_split() + IRResampler::taps(sJob.nTailFactor));
+        }
 
-            // OK, files have been rendered, now need to commutate
-            for (size_t i=0; i<nChannels; ++i)
-            {
-                channel_t *c    = &vChannels[i];
+        size_t impulse_responses::hybrid_split() const
+        {
+            const size_t split  = dspu::millis_to_samples(fSampleRate, sJob.fHybridSplit);
+            return lsp_max(split, IRFdn::min_split(fSampleRate));
+        }
 
-                // Destroy previously allocated convolver
-                destroy_convolver(c->pSwap);
+        bool impulse_responses::use_hybrid(size_t span) const
+        {
+            return (sJob.bHybrid) && (span > hybrid_split() + dspu::millis_to_samples(fSampleRate, HYBRID_FADE));
+        }
 
-                // Check that routing has changed
-                size_t ch   = c->nSource;
-                if (ch == 0)
-                    continue;
-                --ch;
+        status_t impulse_responses::init_hybrid_kernel(IRKernel *k, IRFdn *synth, const float *ir, size_t length, size_t silence)
+        {
+            const size_t fade   = dspu::millis_to_samples(fSampleRate, HYBRID_FADE);
+            const size_t split  = hybrid_split();
+            const size_t early  = split + fade;
+
+            // The early part fades out after the crossover point, the kernel layout does not
+            // depend on the response, so kernels of all paths are compatible
+            float *buf          = reinterpret_cast<float *>(IRArena::acquire(&sArena, early * sizeof(float)));
+            if (buf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { IRArena::release(&sArena, reinterpret_cast<uint8_t *>(buf)); };
 
-                // Apply new routing
-                size_t track    = ch % meta::impulse_responses_metadata::TRACKS_MAX;
-                size_t file     = ch / meta::impulse_responses_metadata::TRACKS_MAX;
-                if (file >= nChannels)
-                    continue;
+            const size_t e_len  = lsp_min(length, early);
+            dsp::copy(buf, ir, e_len);
+            dsp::fill_zero(&buf[e_len], early - e_len);
+            dspu::fade_out(buf, buf, fade, early);
+            if (!k->init(buf, early, early, silence, sJob.nRank, sJob.nLatency, nImmediate))
+                return STATUS_NO_MEM;
 
-                // Analyze sample
-                dspu::Sample *s = vFiles[file].pProcessed;
-                if ((s == NULL) || (!s->valid()) || (s->channels() <= track))
-                    continue;
+            // Fit the network to the tail, the tail without measurable decay is not synthesized
+            status_t res        = synth->fit(ir, length, split, sJob.nLatency, fSampleRate);
+            if (res == STATUS_NO_MEM)
+                return res;
+            if (res != STATUS_OK)
+                synth->destroy();
 
-                // Now we can create convolver
-                dspu::Convolver *cv   = new dspu::Convolver();
-                if (cv == NULL)
-                    continue;
-                lsp_finally { destroy_convolver(cv); };
+            return STATUS_OK;
+        }
 
-                // Initialize convolver
-                if (!cv->init(s->channel(track), s->length(), nRank, float((phase + i*step) & 0x7fffffff)/float(0x80000000)))
-                    return STATUS_NO_MEM;
+        status_t impulse_responses::init_split_kernel(IRKernel *k, IRKernel *tail, const float *ir, size_t length, size_t span, size_t silence)
+        {
+            const size_t factor = sJob.nTailFactor;
+            const size_t fade   = IRResampler::taps(factor);
+            const size_t split  = tail_split();
+            const size_t early  = split + fade;
+            const size_t shift  = IRResampler::delay(factor) * 2;
+
+            // The layout of both parts depends only on the span, so kernels of all paths are compatible
+            const size_t t_len  = span + sJob.nLatency - shift;
+            const size_t d_len  = IRResampler::decimated_length(t_len, factor);
+            const size_t count  = early + t_len + d_len;
+            float *e_buf        = reinterpret_cast<float *>(IRArena::acquire(&sArena, count * sizeof(float)));
+            if (e_buf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { IRArena::release(&sArena, reinterpret_cast<uint8_t *>(e_buf)); };
+            float *t_buf        = &e_buf[early];
+            float *d_buf        = &t_buf[t_len];
+
+            // The early part fades out after the crossover point
+            const size_t e_len  = lsp_min(length, early);
+            dsp::copy(e_buf, ir, e_len);
+            dsp::fill_zero(&e_buf[e_len], early - e_len);
+            dspu::fade_out(e_buf, e_buf, fade, early);
+            if (!k->init(e_buf, early, early, silence, sJob.nRank, sJob.nLatency, nImmediate))
+                return STATUS_NO_MEM;
 
-                // Commit convolver
-                lsp::swap(c->pSwap, cv);
+            // The tail fades in after the crossover point, it is delayed by the latency of the
+            // convolver and advanced by the delay of resampling filters, then band-limited and decimated
+            const size_t pos    = split + sJob.nLatency - shift;
+            dsp::fill_zero(t_buf, t_len);
+            if (length > split)
+            {
+                dsp::copy(&t_buf[pos], &ir[split], length - split);
+                dspu::fade_in(&t_buf[pos], &t_buf[pos], fade, length - split);
             }
+            IRResampler::decimate(d_buf, t_buf, t_len, factor);
 
-            return STATUS_OK;
+            // The leading silence of the tail is known from the crossover point
+            const size_t t_silence  = (pos - IRResampler::delay(factor)) / factor;
+            const size_t t_immediate    = (nImmediate < SIZE_MAX) ? nImmediate / factor : SIZE_MAX;
+            return (tail->init(d_buf, d_len, d_len, t_silence, sJob.nRank, 0, t_immediate)) ? STATUS_OK : STATUS_NO_MEM;
         }
 
         void impulse_responses::dump(dspu::IStateDumper *v) const
@@ -1085,8 +3350,35 @@ namespace lsp
             plug::Module::dump(v);
 
             v->write_object("sConfigurator", &sConfigurator);
+            v->write_object("sPreparer", &sPreparer);
             v->write_object("sGCTask", &sGCTask);
+            v->write_object("sArena", &sArena);
+            v->begin_array("vKCQueue", vKCQueue, nKCQueue);
+            {
+                for (size_t i=0; i<nKCQueue; ++i)
+                {
+                    const kc_request_t *r   = &vKCQueue[i];
+                    v->begin_object(r, sizeof(kc_request_t));
+                    {
+                        v->write("pKernel", r->pKernel);
+                        v->begin_object("sKey", &r->sKey, sizeof(IRRegistry::kernel_key_t));
+                        {
+                            v->write("nHash", r->sKey.nHash);
+                            v->write("nSampleRate", r->sKey.nSampleRate);
+                            v->write("nRank", r->sKey.nRank);
+                            v->write("nLatency", r->sKey.nLatency);
+                        }
+                        v->end_object();
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("nKCQueue", nKCQueue);
+            v->write_object("sWorker", &sWorker);
             v->write("nChannels", nChannels);
+            v->write("nInputs", nInputs);
+            v->write("nFiles", nFiles);
             v->begin_array("vChannels", vChannels, nChannels);
             {
                 for (size_t i=0; i<nChannels; ++i)
@@ -1095,20 +3387,41 @@ namespace lsp
                     v->begin_object(c, sizeof(channel_t));
                     {
                         v->write_object("sBypass", &c->sBypass);
-                        v->write_object("sDelay", &c->sDelay);
+                        v->write_object("sDryDelay", &c->sDryDelay);
                         v->write_object("sPlayer", &c->sPlayer);
                         v->write_object("sEqualizer", &c->sEqualizer);
                         v->write_object_array("vPlaybacks", c->vPlaybacks, meta::impulse_responses_metadata::FILES_MAX);
 
-                        v->write_object("pCurr", c->pCurr);
+                        v->write("pCurr", c->pCurr);
+                        v->write_object("pLive", c->pLive);
                         v->write_object("pSwap", c->pSwap);
+                        v->write("pFade", c->pFade);
 
                         v->write("vIn", c->vIn);
                         v->write("vOut", c->vOut);
                         v->write("vBuffer", c->vBuffer);
+                        v->write("vWet", c->vWet);
+                        v->write("vDry", c->vDry);
+                        v->write("vHistory", c->vHistory);
+                        v->write("vSwap", c->vSwap);
                         v->write("fDryGain", c->fDryGain);
                         v->write("fWetGain", c->fWetGain);
                         v->write("nSource", c->nSource);
+                        v->write("nPredelay", c->nPredelay);
+                        v->write("bRebuild", c->bRebuild);
+                        v->write("bCommit", c->bCommit);
+                        v->write("nBypassFade", c->nBypassFade);
+                        v->write("nSilence", c->nSilence);
+                        v->write("nPrime", c->nPrime);
+                        v->write("nXFade", c->nXFade);
+                        v->write("nXFadeLen", c->nXFadeLen);
+                        v->write("bSleep", c->bSleep);
+                        v->write("bBypass", c->bBypass);
+                        v->write("bWetEq", c->bWetEq);
+                        v->write("bEqBake", c->bEqBake);
+                        v->write("bEqCommit", c->bEqCommit);
+                        v->write("bEqBaked", c->bEqBaked);
+                        v->write("bEqLive", c->bEqLive);
 
                         v->write("pIn", c->pIn);
                         v->write("pOut", c->pOut);
@@ -1116,9 +3429,11 @@ namespace lsp
                         v->write("pSource", c->pSource);
                         v->write("pMakeup", c->pMakeup);
                         v->write("pActivity", c->pActivity);
+                        v->write("pSleep", c->pSleep);
                         v->write("pPredelay", c->pPredelay);
 
                         v->write("pWetEq", c->pWetEq);
+                        v->write("pWetBake", c->pWetBake);
                         v->write("pLowCut", c->pLowCut);
                         v->write("pLowFreq", c->pLowFreq);
                         v->write("pHighCut", c->pHighCut);
@@ -1130,9 +3445,9 @@ namespace lsp
                 }
             }
             v->end_array();
-            v->begin_array("vFiles", vFiles, nChannels);
+            v->begin_array("vFiles", vFiles, nFiles);
             {
-                for (size_t i=0; i<nChannels; ++i)
+                for (size_t i=0; i<nFiles; ++i)
                 {
                     const af_descriptor_t *af = &vFiles[i];
                     v->begin_object(af, sizeof(af_descriptor_t));
@@ -1141,20 +3456,59 @@ namespace lsp
                         v->write_object("sStop", &af->sStop);
                         v->write_object("pOriginal", af->pOriginal);
                         v->write_object("pProcessed", af->pProcessed);
+                        v->write_object("pActive", af->pActive);
 
                         v->writev("vThumbs", af->vThumbs, meta::impulse_responses_metadata::TRACKS_MAX);
+                        v->begin_array("vCache", af->vCache, RS_CACHE_SIZE);
+                        {
+                            for (size_t j=0; j<RS_CACHE_SIZE; ++j)
+                            {
+                                const rs_cache_t *rc = &af->vCache[j];
+                                v->begin_object(rc, sizeof(rs_cache_t));
+                                {
+                                    v->write_object("pSample", rc->pSample);
+                                    v->write("nSampleRate", rc->nSampleRate);
+                                    v->write("nBytes", rc->nBytes);
+                                    v->write("nAccess", rc->nAccess);
+                                }
+                                v->end_object();
+                            }
+                        }
+                        v->end_array();
 
                         v->write("fNorm", af->fNorm);
                         v->write("nStatus", af->nStatus);
                         v->write("bSync", af->bSync);
+                        v->write("bRender", af->bRender);
+                        v->write("bCommit", af->bCommit);
+                        v->write("bDeferred", af->bDeferred);
+                        v->write_object("pCached", af->pCached);
+                        v->write("nHash", af->nHash);
+                        v->write("nProcessed", af->nProcessed);
+                        v->write("nActive", af->nActive);
                         v->write("bReverse", af->bReverse);
+                        v->write("bAutoTrim", af->bAutoTrim);
 
                         v->write("fPitch", af->fPitch);
                         v->write("fHeadCut", af->fHeadCut);
                         v->write("fTailCut", af->fTailCut);
                         v->write("fFadeIn", af->fFadeIn);
                         v->write("fFadeOut", af->fFadeOut);
+                        v->write("fTrimLevel", af->fTrimLevel);
+                        v->begin_object("sRender", &af->sRender, sizeof(render_params_t));
+                        {
+                            v->write("fPitch", af->sRender.fPitch);
+                            v->write("fHeadCut", af->sRender.fHeadCut);
+                            v->write("fTailCut", af->sRender.fTailCut);
+                            v->write("fFadeIn", af->sRender.fFadeIn);
+                            v->write("fFadeOut", af->sRender.fFadeOut);
+                            v->write("fTrimLevel", af->sRender.fTrimLevel);
+                            v->write("bReverse", af->sRender.bReverse);
+                            v->write("bAutoTrim", af->sRender.bAutoTrim);
+                        }
+                        v->end_object();
                         v->write("fDuration", af->fDuration);
+                        v->write("fRT60", af->fRT60);
 
                         v->write_object("pLoader", af->pLoader);
 
@@ -1167,8 +3521,12 @@ namespace lsp
                         v->write("pListen", af->pListen);
                         v->write("pStop", af->pStop);
                         v->write("pReverse", af->pReverse);
+                        v->write("pAutoTrim", af->pAutoTrim);
+                        v->write("pTrimLevel", af->pTrimLevel);
                         v->write("pStatus", af->pStatus);
                         v->write("pLength", af->pLength);
+                        v->write("pTrimmed", af->pTrimmed);
+                        v->write("pRT60", af->pRT60);
                         v->write("pThumbs", af->pThumbs);
                     }
                     v->end_object();
@@ -1179,16 +3537,112 @@ namespace lsp
             v->write("pExecutor", pExecutor);
             v->write("nReconfigReq", nReconfigReq);
             v->write("nReconfigResp", nReconfigResp);
+            v->write("nCancel", nCancel);
+            v->write("nJobFiles", nJobFiles);
+            v->begin_object("sJob", &sJob, sizeof(job_settings_t));
+            {
+                v->write("nRank", sJob.nRank);
+                v->write("nLatency", sJob.nLatency);
+                v->write("nTailFactor", sJob.nTailFactor);
+                v->write("fTailSplit", sJob.fTailSplit);
+                v->write("fHybridSplit", sJob.fHybridSplit);
+                v->write("bHybrid", sJob.bHybrid);
+                v->write("bTrueStereo", sJob.bTrueStereo);
+                v->write("bMatrix", sJob.bMatrix);
+                v->write("bMorph", sJob.bMorph);
+                v->write("bDiskCache", sJob.bDiskCache);
+            }
+            v->end_object();
+            v->write("nJobsDone", nJobsDone);
+            v->write("nJobsCancelled", nJobsCancelled);
+            v->write("nSettleReq", nSettleReq);
+            v->write("nSettle", nSettle);
+            v->write("bPreview", bPreview);
+            v->write("bRefine", bRefine);
             v->write("fGain", fGain);
             v->write("nRank", nRank);
+            v->write("nLatency", nLatency);
+            v->write("nDelay", nDelay);
+            v->write("nImmediate", nImmediate);
+            v->write("bTrueStereo", bTrueStereo);
+            v->write("nTailFactor", nTailFactor);
+            v->write("fTailSplit", fTailSplit);
+            v->write("bHybrid", bHybrid);
+            v->write("fHybridSplit", fHybridSplit);
+            v->write("nXFade", nXFade);
+            v->write("nHistPos", nHistPos);
+            v->write("nWetPos", nWetPos);
+            v->write("nHistFill", nHistFill);
+            v->write("bMorph", bMorph);
+            v->write("fMorph", fMorph);
+            v->begin_array("vBank", vBank, meta::impulse_responses_metadata::BANK_SLOTS);
+            {
+                for (size_t i=0; i<meta::impulse_responses_metadata::BANK_SLOTS; ++i)
+                {
+                    const bank_slot_t *b = &vBank[i];
+                    v->begin_object(b, sizeof(bank_slot_t));
+                    {
+                        v->writev("vConv", b->vConv, IRConvolver::CHANNELS_MAX);
+                        v->writev("vEqBaked", b->vEqBaked, IRConvolver::CHANNELS_MAX);
+                        v->write("nLatency", b->nLatency);
+                        v->write("nSampleRate", b->nSampleRate);
+                        v->write("nSize", b->nSize);
+                        v->write("bUsed", b->bUsed);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write_object("sBankStore", &sBankStore);
+            v->write_object("sBankClear", &sBankClear);
+            v->write("nSlot", nSlot);
+            v->write("nSlotReq", nSlotReq);
+            v->write("nBankTarget", nBankTarget);
+            v->write("nStoreReq", nStoreReq);
+            v->write("nStoreSlot", nStoreSlot);
+            v->write("nClearReq", nClearReq);
+            v->write("nBankLimit", nBankLimit);
+            v->write("nBankStatus", nBankStatus);
+            v->write("bDiskCache", bDiskCache);
+            v->write("nCacheClock", nCacheClock);
+            v->write("nCacheHits", nCacheHits);
+            v->write("nCacheMisses", nCacheMisses);
+            v->write("pRegistry", pRegistry);
+            v->write_object("pPool", pPool);
+            v->write("nSharedBytes", pRegistry->resident_bytes());
             v->write("pGCList", pGCList);
 
             v->write("pBypass", pBypass);
             v->write("pRank", pRank);
+            v->write("pLatency", pLatency);
             v->write("pDry", pDry);
             v->write("pWet", pWet);
             v->write("pDryWet", pDryWet);
             v->write("pOutGain", pOutGain);
+            v->write("pDiskCache", pDiskCache);
+            v->write("pCacheHits", pCacheHits);
+            v->write("pTrueStereo", pTrueStereo);
+            v->write("pMorph", pMorph);
+            v->write("pMorphAmount", pMorphAmount);
+            v->write("pTailOn", pTailOn);
+            v->write("pTailSplit", pTailSplit);
+            v->write("pTailFactor", pTailFactor);
+            v->write("pTailSaving", pTailSaving);
+            v->write("pHybrid", pHybrid);
+            v->write("pHybridSplit", pHybridSplit);
+            v->write("pHybridError", pHybridError);
+            v->write("pXFade", pXFade);
+            v->write("pSwapLoad", pSwapLoad);
+            v->write("pJobsDone", pJobsDone);
+            v->write("pJobsCancelled", pJobsCancelled);
+            v->write("pBankSlot", pBankSlot);
+            v->write("pBankTarget", pBankTarget);
+            v->write("pBankStore", pBankStore);
+            v->write("pBankClear", pBankClear);
+            v->write("pBankLimit", pBankLimit);
+            v->write("pBankStatus", pBankStatus);
+            v->write("pBankUsage", pBankUsage);
+            v->write("pSharedMemory", pSharedMemory);
 
             v->write("pData", pData);
         }
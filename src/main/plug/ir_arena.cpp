@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_arena.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        IRArena::IRArena()
+        {
+            pFree       = NULL;
+            nFree       = 0;
+            nUsed       = 0;
+            nAllocs     = 0;
+            nReuses     = 0;
+            nEpoch      = 0;
+            for (size_t i=0; i<SAMPLES_MAX; ++i)
+            {
+                vSamples[i] = NULL;
+                vEpochs[i]  = 0;
+            }
+        }
+
+        IRArena::~IRArena()
+        {
+            destroy();
+        }
+
+        IRArena::block_t *IRArena::header(uint8_t *ptr)
+        {
+            return reinterpret_cast<block_t *>(ptr - HEADER_SIZE);
+        }
+
+        void IRArena::free_list(block_t *list)
+        {
+            while (list != NULL)
+            {
+                block_t *next   = list->pNext;
+                uint8_t *raw    = list->pRaw;
+                free_aligned(raw);
+                list            = next;
+            }
+        }
+
+        void IRArena::destroy_sample(dspu::Sample *s)
+        {
+            s->destroy();
+            delete s;
+        }
+
+        uint8_t *IRArena::acquire(IRArena *arena, size_t bytes)
+        {
+            bytes           = align_size(lsp_max(bytes, size_t(1)), DEFAULT_ALIGN);
+
+            if (arena != NULL)
+            {
+                arena->sLock.lock();
+                lsp_finally { arena->sLock.unlock(); };
+
+                // Take the smallest released block which does not waste more than a half of it
+                block_t **best  = NULL;
+                for (block_t **pb = &arena->pFree; *pb != NULL; pb = &(*pb)->pNext)
+                {
+                    const size_t size = (*pb)->nSize;
+                    if ((size < bytes) || (size > bytes * 2))
+                        continue;
+                    if ((best == NULL) || (size < (*best)->nSize))
+                        best            = pb;
+                }
+
+                if (best != NULL)
+                {
+                    block_t *b      = *best;
+                    *best           = b->pNext;
+                    b->pNext        = NULL;
+                    arena->nFree   -= b->nSize;
+                    arena->nUsed   += b->nSize;
+                    ++arena->nReuses;
+                    return reinterpret_cast<uint8_t *>(b) + HEADER_SIZE;
+                }
+            }
+
+            // Allocate new block on the heap
+            uint8_t *raw    = NULL;
+            uint8_t *ptr    = alloc_aligned<uint8_t>(raw, HEADER_SIZE + bytes, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return NULL;
+
+            block_t *b      = reinterpret_cast<block_t *>(ptr);
+            b->pNext        = NULL;
+            b->nSize        = bytes;
+            b->nEpoch       = 0;
+            b->pRaw         = raw;
+
+            if (arena != NULL)
+            {
+                arena->sLock.lock();
+                arena->nUsed   += bytes;
+                ++arena->nAllocs;
+                arena->sLock.unlock();
+            }
+
+            return ptr + HEADER_SIZE;
+        }
+
+        void IRArena::release(IRArena *arena, uint8_t *ptr)
+        {
+            if (ptr == NULL)
+                return;
+
+            block_t *b      = header(ptr);
+            if (arena == NULL)
+            {
+                b->pNext        = NULL;
+                free_list(b);
+                return;
+            }
+
+            arena->sLock.lock();
+            lsp_finally { arena->sLock.unlock(); };
+
+            b->nEpoch       = arena->nEpoch;
+            b->pNext        = arena->pFree;
+            arena->pFree    = b;
+            arena->nUsed   -= b->nSize;
+            arena->nFree   += b->nSize;
+        }
+
+        dspu::Sample *IRArena::acquire_sample(size_t channels, size_t length)
+        {
+            const size_t capacity   = lsp_max(length, size_t(1));
+
+            // Take the smallest spare sample which does not waste more than a half of it
+            sLock.lock();
+            ssize_t best    = -1;
+            for (size_t i=0; i<SAMPLES_MAX; ++i)
+            {
+                dspu::Sample *s = vSamples[i];
+                if ((s == NULL) || (s->channels() != channels))
+                    continue;
+                const size_t size   = s->max_length();
+                if ((size < capacity) || (size > capacity * 2))
+                    continue;
+                if ((best < 0) || (size < vSamples[best]->max_length()))
+                    best            = i;
+            }
+
+            dspu::Sample *s = NULL;
+            if (best >= 0)
+            {
+                s               = vSamples[best];
+                vSamples[best]  = NULL;
+                ++nReuses;
+            }
+            sLock.unlock();
+
+            if (s != NULL)
+            {
+                s->set_length(length);
+                return s;
+            }
+
+            // Allocate new sample
+            s               = new dspu::Sample();
+            if (s == NULL)
+                return NULL;
+            if (!s->init(channels, capacity, length))
+            {
+                destroy_sample(s);
+                return NULL;
+            }
+
+            sLock.lock();
+            ++nAllocs;
+            sLock.unlock();
+
+            return s;
+        }
+
+        void IRArena::release_sample(dspu::Sample *s)
+        {
+            if (s == NULL)
+                return;
+
+            // Keep the sample in the free slot or replace the smallest one
+            sLock.lock();
+            ssize_t slot    = -1;
+            for (size_t i=0; i<SAMPLES_MAX; ++i)
+            {
+                if (vSamples[i] == NULL)
+                {
+                    slot            = i;
+                    break;
+                }
+                if ((slot < 0) || (vSamples[i]->max_length() < vSamples[slot]->max_length()))
+                    slot            = i;
+            }
+
+            dspu::Sample *old   = vSamples[slot];
+            if ((old != NULL) && (old->max_length() > s->max_length()))
+                old                 = s;
+            else
+            {
+                vSamples[slot]      = s;
+                vEpochs[slot]       = nEpoch;
+            }
+            sLock.unlock();
+
+            if (old != NULL)
+                destroy_sample(old);
+        }
+
+        void IRArena::trim()
+        {
+            block_t *list   = NULL;
+            dspu::Sample *samples[SAMPLES_MAX];
+            size_t count    = 0;
+
+            // Detach blocks and samples released before the previous trim
+            sLock.lock();
+            for (block_t **pb = &pFree; *pb != NULL; )
+            {
+                block_t *b      = *pb;
+                if (b->nEpoch == nEpoch)
+                {
+                    pb              = &b->pNext;
+                    continue;
+                }
+
+                *pb             = b->pNext;
+                nFree          -= b->nSize;
+                b->pNext        = list;
+                list            = b;
+            }
+            for (size_t i=0; i<SAMPLES_MAX; ++i)
+            {
+                if ((vSamples[i] == NULL) || (vEpochs[i] == nEpoch))
+                    continue;
+                samples[count++]    = vSamples[i];
+                vSamples[i]         = NULL;
+            }
+            ++nEpoch;
+            sLock.unlock();
+
+            // Free detached memory outside of the lock
+            free_list(list);
+            for (size_t i=0; i<count; ++i)
+                destroy_sample(samples[i]);
+        }
+
+        void IRArena::destroy()
+        {
+            sLock.lock();
+            block_t *list   = pFree;
+            pFree           = NULL;
+            nFree           = 0;
+            sLock.unlock();
+            free_list(list);
+
+            for (size_t i=0; i<SAMPLES_MAX; ++i)
+            {
+                if (vSamples[i] != NULL)
+                {
+                    destroy_sample(vSamples[i]);
+                    vSamples[i]     = NULL;
+                }
+            }
+
+            // All blocks should be released before the arena gets destroyed
+            if (nUsed > 0)
+                lsp_warn("Arena still has %d bytes in use", int(nUsed));
+        }
+
+        void IRArena::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pFree", pFree);
+            v->write("nFree", nFree);
+            v->write("nUsed", nUsed);
+            v->write("nAllocs", nAllocs);
+            v->write("nReuses", nReuses);
+            v->write("nEpoch", nEpoch);
+            v->writev("vSamples", vSamples, SAMPLES_MAX);
+            v->writev("vEpochs", vEpochs, SAMPLES_MAX);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,1198 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_convolver.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t DIRECT_SIZE     = IRKernel::HEAD_SIZE * 2;
+        static constexpr size_t ASYNC_BLOCK_MIN = 1024;     // Minimum block size of the level processed by the worker
+        static constexpr size_t DELAY_BLOCK     = 1024;     // Maximum number of samples delayed at once
+
+        static inline void ring_write(float *ring, size_t size, size_t pos, const float *src, size_t count)
+        {
+            const size_t tail   = size - pos;
+            if (count <= tail)
+                dsp::copy(&ring[pos], src, count);
+            else
+            {
+                dsp::copy(&ring[pos], src, tail);
+                dsp::copy(ring, &src[tail], count - tail);
+            }
+        }
+
+        static inline void ring_read(float *dst, const float *ring, size_t size, size_t pos, size_t count)
+        {
+            const size_t tail   = size - pos;
+            if (count <= tail)
+                dsp::copy(dst, &ring[pos], count);
+            else
+            {
+                dsp::copy(dst, &ring[pos], tail);
+                dsp::copy(&dst[tail], ring, count - tail);
+            }
+        }
+
+        //---------------------------------------------------------------------
+        IRConvolver::LevelJob::LevelJob(IRConvolver *core, level_t *level)
+        {
+            pCore       = core;
+            pLevel      = level;
+            for (size_t i=0; i<CHANNELS_MAX; ++i)
+            {
+                vInput[i]   = NULL;
+                vResult[i]  = NULL;
+            }
+            vAcc        = NULL;
+            vTemp       = NULL;
+        }
+
+        IRConvolver::LevelJob::~LevelJob()
+        {
+            pCore       = NULL;
+            pLevel      = NULL;
+        }
+
+        void IRConvolver::LevelJob::execute()
+        {
+            pCore->transform(pLevel, vInput, vResult, vAcc, vTemp);
+        }
+
+        //---------------------------------------------------------------------
+        IRConvolver::IRConvolver(): IRConvolver(NULL)
+        {
+        }
+
+        IRConvolver::IRConvolver(IRArena *arena)
+        {
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                vKernels[i] = NULL;
+                vSynth[i]   = NULL;
+                vMorph[i]   = NULL;
+                vMixHead[i] = NULL;
+            }
+            nSynth      = 0;
+            fMorph      = 0.0f;
+            fHeadMorph  = 0.0f;
+            bMorph      = false;
+            pWorker     = NULL;
+            pTail       = NULL;
+            nInputs     = 0;
+            nOutputs    = 0;
+            nLatency    = 0;
+            nLength     = 0;
+            nDelay      = 0;
+            nDelayPos   = 0;
+            nHead       = 0;
+            nLevels     = 0;
+            for (size_t i=0; i<CHANNELS_MAX; ++i)
+            {
+                vDown[i]    = NULL;
+                vUp[i]      = NULL;
+                vTailIn[i]  = NULL;
+                vTailOut[i] = NULL;
+                vDirect[i]  = NULL;
+                vDelay[i]   = NULL;
+                vDelayed[i] = NULL;
+            }
+            nFactor     = 0;
+            fSaving     = 0.0f;
+            vAcc        = NULL;
+            vTemp       = NULL;
+            nMisses     = 0;
+            nSkips      = 0;
+            nSize       = 0;
+            pArena      = arena;
+            pData       = NULL;
+
+            for (size_t i=0; i<IRKernel::LEVELS_MAX; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                l->nIndex       = i;
+                l->nRank        = 0;
+                l->nBlock       = 0;
+                l->nFirst       = 0;
+                l->nParts       = 0;
+                for (size_t j=0; j<CHANNELS_MAX; ++j)
+                {
+                    l->vFrame[j]    = NULL;
+                    l->vOut[j]      = NULL;
+                    l->vHistory[j]  = NULL;
+                    l->vPending[j]  = NULL;
+                }
+                l->nHistory     = 0;
+                l->nHead        = 0;
+                l->nFill        = 0;
+                l->nLag         = 1;
+                l->fMorph       = 0.0f;
+                l->pJob         = NULL;
+                l->nDropped     = 0;
+                l->bPending     = false;
+                l->bClear       = false;
+            }
+        }
+
+        IRConvolver::~IRConvolver()
+        {
+            destroy();
+        }
+
+        void IRConvolver::destroy()
+        {
+            // Wait until the worker releases jobs
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                if (l->pJob == NULL)
+                    continue;
+
+                l->pJob->sync();
+                delete l->pJob;
+                l->pJob         = NULL;
+            }
+
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                IRKernel::release(vKernels[i]);
+                vKernels[i]     = NULL;
+                IRKernel::release(vMorph[i]);
+                vMorph[i]       = NULL;
+                vMixHead[i]     = NULL;
+            }
+            fMorph      = 0.0f;
+            fHeadMorph  = 0.0f;
+            bMorph      = false;
+
+            // Destroy the tail
+            if (pTail != NULL)
+            {
+                pTail->destroy();
+                delete pTail;
+                pTail           = NULL;
+            }
+            for (size_t i=0; i<CHANNELS_MAX; ++i)
+            {
+                if (vDown[i] != NULL)
+                {
+                    delete vDown[i];
+                    vDown[i]        = NULL;
+                }
+                if (vUp[i] != NULL)
+                {
+                    delete vUp[i];
+                    vUp[i]          = NULL;
+                }
+                vTailIn[i]      = NULL;
+                vTailOut[i]     = NULL;
+            }
+            nFactor     = 0;
+            fSaving     = 0.0f;
+
+            // Destroy networks
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                IRFdn *fdn      = vSynth[i];
+                if (fdn == NULL)
+                    continue;
+                fdn->destroy();
+                delete fdn;
+                vSynth[i]       = NULL;
+            }
+            nSynth      = 0;
+
+            IRArena::release(pArena, pData);
+            pData       = NULL;
+
+            pWorker     = NULL;
+            nInputs     = 0;
+            nOutputs    = 0;
+            nLatency    = 0;
+            nLength     = 0;
+            nDelay      = 0;
+            nDelayPos   = 0;
+            nHead       = 0;
+            nLevels     = 0;
+            for (size_t i=0; i<CHANNELS_MAX; ++i)
+            {
+                vDirect[i]  = NULL;
+                vDelay[i]   = NULL;
+                vDelayed[i] = NULL;
+            }
+            vAcc        = NULL;
+            vTemp       = NULL;
+            nMisses     = 0;
+            nSkips      = 0;
+            nSize       = 0;
+        }
+
+        bool IRConvolver::init(IRKernel *kernel, float phase, IRWorker *worker)
+        {
+            IRKernel *kernels[CHANNELS_MAX];
+            kernels[0]      = kernel;
+            kernels[1]      = NULL;
+
+            return init(kernels, 1, 1, phase, worker);
+        }
+
+        bool IRConvolver::init(IRKernel *kernel, IRKernel *tail, size_t factor, float phase, IRWorker *worker)
+        {
+            IRKernel *kernels[CHANNELS_MAX];
+            IRKernel *tails[CHANNELS_MAX];
+            kernels[0]      = kernel;
+            kernels[1]      = NULL;
+            tails[0]        = tail;
+            tails[1]        = NULL;
+
+            return init(kernels, (tail != NULL) ? tails : NULL, factor, 1, 1, phase, worker);
+        }
+
+        bool IRConvolver::init(IRKernel * const *kernels, size_t inputs, size_t outputs, float phase, IRWorker *worker)
+        {
+            return init(kernels, NULL, 0, inputs, outputs, phase, worker);
+        }
+
+        bool IRConvolver::init(IRKernel * const *kernels, IRKernel * const *tail, size_t factor,
+            size_t inputs, size_t outputs, float phase, IRWorker *worker)
+        {
+            return create(kernels, NULL, tail, factor, inputs, outputs, phase, worker);
+        }
+
+        bool IRConvolver::init_morph(IRKernel *kernel, IRKernel *morph, float phase, IRWorker *worker)
+        {
+            IRKernel *kernels[CHANNELS_MAX];
+            IRKernel *morphs[CHANNELS_MAX];
+            kernels[0]      = kernel;
+            kernels[1]      = NULL;
+            morphs[0]       = morph;
+            morphs[1]       = NULL;
+
+            return create(kernels, morphs, NULL, 0, 1, 1, phase, worker);
+        }
+
+        bool IRConvolver::create(IRKernel * const *kernels, IRKernel * const *morph, IRKernel * const *tail, size_t factor,
+            size_t inputs, size_t outputs, float phase, IRWorker *worker)
+        {
+            if ((inputs <= 0) || (inputs > CHANNELS_MAX) ||
+                (outputs <= 0) || (outputs > CHANNELS_MAX))
+                return false;
+
+            // All kernels should have the same layout, the kernel to morph requires the main kernel
+            const IRKernel *layout  = NULL;
+            size_t morphs           = 0;
+            for (size_t i=0; i<inputs; ++i)
+                for (size_t j=0; j<outputs; ++j)
+                {
+                    const IRKernel *k   = kernels[i * CHANNELS_MAX + j];
+                    const IRKernel *m   = (morph != NULL) ? morph[i * CHANNELS_MAX + j] : NULL;
+                    if (k == NULL)
+                    {
+                        if (m != NULL)
+                            return false;
+                        continue;
+                    }
+                    if (layout == NULL)
+                        layout              = k;
+                    else if (!layout->compatible(k))
+                        return false;
+                    if (m == NULL)
+                        continue;
+                    if (!layout->compatible(m))
+                        return false;
+                    ++morphs;
+                }
+            if (layout == NULL)
+                return false;
+
+            // Select levels which have active partitions in any of kernels,
+            // the partitions after the last active one are not processed
+            size_t index[IRKernel::LEVELS_MAX];
+            size_t parts[IRKernel::LEVELS_MAX];
+            size_t levels       = 0;
+            size_t max_rank     = 0;
+            for (size_t l=0; l<layout->levels(); ++l)
+            {
+                size_t n            = 0;
+                for (size_t i=0; i<inputs * CHANNELS_MAX * 2; ++i)
+                {
+                    const size_t path   = i >> 1;
+                    const IRKernel *k   = (i & 1) ? ((morph != NULL) ? morph[path] : NULL) : kernels[path];
+                    if ((k == NULL) || ((path % CHANNELS_MAX) >= outputs))
+                        continue;
+                    const IRKernel::level_t *kl = k->level(l);
+                    for (size_t p=kl->nParts; p > n; --p)
+                        if (kl->vActive[p - 1])
+                        {
+                            n               = p;
+                            break;
+                        }
+                }
+                if (n <= 0)
+                    continue;
+
+                index[levels]       = l;
+                parts[levels]       = n;
+                max_rank            = lsp_max(max_rank, layout->level(l)->nRank);
+                ++levels;
+            }
+
+            // Estimate the amount of memory
+            const size_t delay  = layout->delay();
+            const size_t fft    = (levels > 0) ? size_t(1) << (max_rank + 1) : 0;
+            size_t floats       = DIRECT_SIZE * outputs + fft * 2 + layout->head_size() * morphs;
+            if (delay > 0)
+                floats             += (delay + DELAY_BLOCK * 2) * inputs;
+            const size_t tail_block = (tail != NULL) ? IRResampler::BLOCK_SIZE / factor + 1 : 0;
+            floats             += tail_block * (inputs + outputs);
+            size_t lag[IRKernel::LEVELS_MAX];
+            for (size_t i=0; i<levels; ++i)
+            {
+                const IRKernel::level_t *kl = layout->level(index[i]);
+                const size_t b              = kl->nBlock;
+                lag[i]                      = ((worker != NULL) && (kl->nFirst >= 2) && (b >= ASYNC_BLOCK_MIN)) ? 2 : 1;
+                const size_t history        = kl->nFirst + parts[i] - lag[i];
+                floats                     += (b * 2 + history * b * 4) * inputs + b * outputs;
+                if (lag[i] > 1)
+                    floats                     += b * 4 * inputs + b * outputs + b * 8; // Inputs, pending frames, results, accumulator and temporary buffer of the job
+            }
+
+            // Allocate jobs
+            LevelJob *jobs[IRKernel::LEVELS_MAX];
+            for (size_t i=0; i<levels; ++i)
+                jobs[i]                     = NULL;
+            lsp_finally {
+                for (size_t i=0; i<levels; ++i)
+                    if (jobs[i] != NULL)
+                        delete jobs[i];
+            };
+            for (size_t i=0; i<levels; ++i)
+            {
+                if (lag[i] <= 1)
+                    continue;
+                jobs[i]                     = new LevelJob(this, &vLevels[i]);
+                if (jobs[i] == NULL)
+                    return false;
+            }
+
+            // Allocate resamplers of the tail
+            IRResampler *down[CHANNELS_MAX];
+            IRResampler *up[CHANNELS_MAX];
+            for (size_t i=0; i<CHANNELS_MAX; ++i)
+            {
+                down[i]                     = NULL;
+                up[i]                       = NULL;
+            }
+            lsp_finally {
+                for (size_t i=0; i<CHANNELS_MAX; ++i)
+                {
+                    if (down[i] != NULL)
+                        delete down[i];
+                    if (up[i] != NULL)
+                        delete up[i];
+                }
+            };
+            if (tail != NULL)
+            {
+                for (size_t i=0; i<inputs; ++i)
+                {
+                    down[i]                     = new IRResampler();
+                    if ((down[i] == NULL) || (!down[i]->init(factor)))
+                        return false;
+                }
+                for (size_t i=0; i<outputs; ++i)
+                {
+                    up[i]                       = new IRResampler();
+                    if ((up[i] == NULL) || (!up[i]->init(factor)))
+                        return false;
+                }
+            }
+
+            // Allocate memory and initialize state
+            IRArena *arena      = pArena;
+            uint8_t *data       = IRArena::acquire(arena, floats * sizeof(float));
+            if (data == NULL)
+                return false;
+            float *ptr          = reinterpret_cast<float *>(data);
+            dsp::fill_zero(ptr, floats);
+
+            // Initialize the tail convolver, it takes references to the tail kernels
+            IRConvolver *tcv    = NULL;
+            if (tail != NULL)
+            {
+                tcv                 = new IRConvolver(arena);
+                if ((tcv == NULL) || (!tcv->init(tail, inputs, outputs, phase, worker)))
+                {
+                    if (tcv != NULL)
+                        delete tcv;
+                    IRArena::release(arena, data);
+                    return false;
+                }
+            }
+
+            destroy();
+
+            phase               = lsp_limit(phase, 0.0f, 1.0f);
+            for (size_t i=0; i<outputs; ++i)
+            {
+                vDirect[i]          = ptr;
+                ptr                += DIRECT_SIZE;
+            }
+            vAcc                = ptr;
+            ptr                += fft;
+            vTemp               = ptr;
+            ptr                += fft;
+            if (morphs > 0)
+            {
+                for (size_t i=0; i<inputs; ++i)
+                    for (size_t j=0; j<outputs; ++j)
+                    {
+                        const size_t path   = i * CHANNELS_MAX + j;
+                        if (morph[path] == NULL)
+                            continue;
+                        vMixHead[path]      = ptr;
+                        ptr                += layout->head_size();
+                    }
+            }
+            if (delay > 0)
+            {
+                for (size_t i=0; i<inputs; ++i)
+                {
+                    vDelay[i]           = ptr;
+                    ptr                += delay + DELAY_BLOCK;
+                    vDelayed[i]         = ptr;
+                    ptr                += DELAY_BLOCK;
+                }
+            }
+            if (tcv != NULL)
+            {
+                for (size_t i=0; i<inputs; ++i)
+                {
+                    vTailIn[i]          = ptr;
+                    ptr                += tail_block;
+                    lsp::swap(vDown[i], down[i]);
+                }
+                for (size_t i=0; i<outputs; ++i)
+                {
+                    vTailOut[i]         = ptr;
+                    ptr                += tail_block;
+                    lsp::swap(vUp[i], up[i]);
+                }
+            }
+
+            for (size_t i=0; i<levels; ++i)
+            {
+                level_t *l          = &vLevels[i];
+                const IRKernel::level_t *kl = layout->level(index[i]);
+                const size_t b      = kl->nBlock;
+
+                l->nIndex           = index[i];
+                l->nRank            = kl->nRank;
+                l->nBlock           = b;
+                l->nFirst           = kl->nFirst;
+                l->nParts           = parts[i];
+                l->nLag             = lag[i];
+                l->nHistory         = kl->nFirst + l->nParts - l->nLag;
+                l->nHead            = 0;
+                l->nFill            = lsp_min(size_t(phase * b), b - 1);
+                l->nDropped         = 0;
+                l->bPending         = false;
+                l->bClear           = false;
+                for (size_t j=0; j<inputs; ++j)
+                {
+                    l->vFrame[j]        = ptr;
+                    ptr                += b * 2;
+                    l->vHistory[j]      = ptr;
+                    ptr                += l->nHistory * b * 4;
+                }
+                for (size_t j=0; j<outputs; ++j)
+                {
+                    l->vOut[j]          = ptr;
+                    ptr                += b;
+                }
+
+                // Initialize the job
+                l->pJob             = jobs[i];
+                jobs[i]             = NULL;
+                if (l->pJob != NULL)
+                {
+                    LevelJob *job       = l->pJob;
+                    for (size_t j=0; j<inputs; ++j)
+                    {
+                        job->vInput[j]      = ptr;
+                        ptr                += b * 2;
+                        l->vPending[j]      = ptr;
+                        ptr                += b * 2;
+                    }
+                    for (size_t j=0; j<outputs; ++j)
+                    {
+                        job->vResult[j]     = ptr;
+                        ptr                += b;
+                    }
+                    job->vAcc           = ptr;
+                    ptr                += b * 4;
+                    job->vTemp          = ptr;
+                    ptr                += b * 4;
+                }
+            }
+
+            // Take references to kernels
+            size_t length       = 0;
+            for (size_t i=0; i<inputs; ++i)
+                for (size_t j=0; j<outputs; ++j)
+                {
+                    IRKernel *k                     = kernels[i * CHANNELS_MAX + j];
+                    vKernels[i * CHANNELS_MAX + j]  = k;
+                    if (k != NULL)
+                        length                          = lsp_max(length, k->length());
+
+                    IRKernel *m                     = (morph != NULL) ? morph[i * CHANNELS_MAX + j] : NULL;
+                    vMorph[i * CHANNELS_MAX + j]    = m;
+                    if (m != NULL)
+                        length                          = lsp_max(length, m->length());
+                }
+
+            pWorker             = worker;
+            nInputs             = inputs;
+            nOutputs            = outputs;
+            nLatency            = layout->latency();
+            nLength             = length + nLatency;
+            nDelay              = delay;
+            nDelayPos           = 0;
+            nHead               = layout->head_size();
+            nLevels             = levels;
+            nSize               = floats * sizeof(float);
+            pData               = data;
+            bMorph              = morphs > 0;
+            if (bMorph)
+                mix_heads();
+
+            // Commit the tail and estimate the reduction of computations compared to
+            // the processing of the tail at the original sample rate
+            if (tcv != NULL)
+            {
+                pTail               = tcv;
+                nFactor             = factor;
+                nLength             = lsp_max(nLength, tcv->length() * factor + IRResampler::delay(factor) * 2);
+
+                const float own     = estimate_cost(1);
+                const float full    = own + tcv->estimate_cost(factor);
+                const float reduced = own + (tcv->estimate_cost(1) + 2.0f * IRResampler::taps(factor) * (inputs + outputs)) / factor;
+                fSaving             = (full > 0.0f) ? lsp_max(1.0f - reduced / full, 0.0f) : 0.0f;
+            }
+
+            return true;
+        }
+
+        float IRConvolver::estimate_cost(size_t stretch) const
+        {
+            // Estimate the number of floating-point operations per sample, the stretch
+            // multiplies the number of partitions as if the response was longer by the factor
+            size_t paths        = 0;
+            for (size_t i=0; i<nInputs; ++i)
+                for (size_t j=0; j<nOutputs; ++j)
+                    if (vKernels[i * CHANNELS_MAX + j] != NULL)
+                        ++paths;
+
+            float cost          = 2.0f * nHead * paths;
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                const level_t *l    = &vLevels[i];
+                const size_t b      = l->nBlock;
+
+                size_t active       = 0;
+                for (size_t j=0; j<CHANNELS_MAX * CHANNELS_MAX; ++j)
+                {
+                    const IRKernel *k   = vKernels[j];
+                    if (k != NULL)
+                        active             += k->level(l->nIndex)->nActive;
+                }
+
+                const float fft     = 5.0f * (b * 2) * l->nRank;
+                const float mac     = 8.0f * (b * 2);
+                cost               += (fft * (nInputs + nOutputs) + mac * active * stretch) / b;
+            }
+
+            return cost;
+        }
+
+        void IRConvolver::transform(level_t *l, float * const *frames, float * const *outs, float *acc, float *tmp)
+        {
+            const size_t b      = l->nBlock;
+            const size_t step   = b * 4;
+
+            // Compute spectra of input frames and store them to delay lines
+            if ((++l->nHead) >= l->nHistory)
+                l->nHead            = 0;
+            for (size_t i=0; i<nInputs; ++i)
+            {
+                float *x            = &l->vHistory[i][l->nHead * step];
+                dsp::pcomplex_r2c(x, frames[i], b * 2);
+                dsp::packed_direct_fft(x, x, l->nRank);
+            }
+
+            // Partition p is applied to the spectrum computed p-lag blocks ago,
+            // that gives the output for the block which starts lag blocks later
+            const size_t first  = (l->nHead + l->nHistory - (l->nFirst - l->nLag)) % l->nHistory;
+
+            for (size_t o=0; o<nOutputs; ++o)
+            {
+                // Accumulate products of all inputs in the frequency domain
+                size_t n            = 0;
+                for (size_t i=0; i<nInputs; ++i)
+                {
+                    const IRKernel *k   = vKernels[i * CHANNELS_MAX + o];
+                    if (k == NULL)
+                        continue;
+
+                    // Products of the kernel to morph are accumulated with weights
+                    const IRKernel *m   = vMorph[i * CHANNELS_MAX + o];
+                    const float *hist   = l->vHistory[i];
+                    if (m == NULL)
+                        n                   = accumulate(acc, tmp, l, hist, k, 1.0f, first, n);
+                    else
+                    {
+                        if (l->fMorph < 1.0f)
+                            n                   = accumulate(acc, tmp, l, hist, k, 1.0f - l->fMorph, first, n);
+                        if (l->fMorph > 0.0f)
+                            n                   = accumulate(acc, tmp, l, hist, m, l->fMorph, first, n);
+                    }
+                }
+
+                // Compute the output
+                if (n > 0)
+                {
+                    dsp::packed_reverse_fft(acc, acc, l->nRank);
+                    dsp::pcomplex_c2r(tmp, acc, b * 2);
+                    dsp::copy(outs[o], &tmp[b], b);
+                }
+                else
+                    dsp::fill_zero(outs[o], b);
+            }
+        }
+
+        size_t IRConvolver::accumulate(float *acc, float *tmp, const level_t *l, const float *hist,
+            const IRKernel *k, float weight, size_t first, size_t n)
+        {
+            const size_t b      = l->nBlock;
+            const size_t step   = b * 4;
+            // The level of the kernel may be not transformed yet
+            if (l->nIndex >= k->ready())
+                return n;
+
+            const IRKernel::level_t *kl = k->level(l->nIndex);
+            const float *parts  = kl->vParts;
+            const uint8_t *act  = kl->vActive;
+            size_t slot         = first;
+
+            for (size_t j=0; j<l->nParts; ++j)
+            {
+                if (act[j])
+                {
+                    if (n > 0)
+                    {
+                        dsp::pcomplex_mul3(tmp, &hist[slot * step], &parts[j * step], b * 2);
+                        if (weight == 1.0f)
+                            dsp::add2(acc, tmp, step);
+                        else
+                            dsp::fmadd_k3(acc, tmp, weight, step);
+                    }
+                    else
+                    {
+                        dsp::pcomplex_mul3(acc, &hist[slot * step], &parts[j * step], b * 2);
+                        if (weight != 1.0f)
+                            dsp::mul_k2(acc, weight, step);
+                    }
+                    ++n;
+                }
+                slot                = (slot > 0) ? slot - 1 : l->nHistory - 1;
+            }
+
+            return n;
+        }
+
+        void IRConvolver::set_morph(float morph)
+        {
+            fMorph              = lsp_limit(morph, 0.0f, 1.0f);
+        }
+
+        void IRConvolver::mix_heads()
+        {
+            // Mix the direct heads of both kernels
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                if (vMorph[i] == NULL)
+                    continue;
+                dsp::mix_copy2(vMixHead[i], vKernels[i]->head(), vMorph[i]->head(), 1.0f - fMorph, fMorph, nHead);
+            }
+            fHeadMorph          = fMorph;
+        }
+
+        void IRConvolver::process_block(level_t *l)
+        {
+            const size_t b      = l->nBlock;
+            LevelJob *job       = l->pJob;
+
+            if (job != NULL)
+            {
+                // The previous job computes the output for the next block, this is the deadline
+                const IRJob::job_deadline_t res = job->complete();
+                if (res == IRJob::JD_BUSY)
+                {
+                    // The real-time thread does not wait for the worker: the level outputs silence for
+                    // the block, the frame is kept and applied when the worker releases the level
+                    ++nSkips;
+                    if (l->bPending)
+                        ++l->nDropped;
+                    for (size_t i=0; i<nInputs; ++i)
+                        dsp::copy(l->vPending[i], l->vFrame[i], b * 2);
+                    for (size_t i=0; i<nOutputs; ++i)
+                        dsp::fill_zero(l->vOut[i], b);
+                    l->bPending         = true;
+                }
+                else
+                {
+                    if (res == IRJob::JD_MISSED)
+                        ++nMisses;
+
+                    // Take the output of the job or compute it from the skipped frames
+                    if (l->bClear)
+                    {
+                        for (size_t i=0; i<nInputs; ++i)
+                            dsp::fill_zero(l->vHistory[i], l->nHistory * b * 4);
+                        for (size_t i=0; i<nOutputs; ++i)
+                            dsp::fill_zero(job->vResult[i], b);
+                        l->bClear           = false;
+                    }
+                    if (l->bPending)
+                        catch_up(l);
+                    else
+                    {
+                        for (size_t i=0; i<nOutputs; ++i)
+                            lsp::swap(l->vOut[i], job->vResult[i]);
+                    }
+
+                    // Submit the new job which computes the output for the block after the next one
+                    for (size_t i=0; i<nInputs; ++i)
+                        dsp::copy(job->vInput[i], l->vFrame[i], b * 2);
+                    l->fMorph           = fMorph;
+                    if (!pWorker->submit(job))
+                        job->run();
+                }
+            }
+            else
+            {
+                l->fMorph           = fMorph;
+                transform(l, l->vFrame, l->vOut, vAcc, vTemp);
+            }
+
+            // Shift input frames
+            for (size_t i=0; i<nInputs; ++i)
+                dsp::copy(l->vFrame[i], &l->vFrame[i][b], b);
+            l->nFill            = 0;
+        }
+
+        void IRConvolver::push_silence(level_t *l, size_t inputs)
+        {
+            const size_t step   = l->nBlock * 4;
+            if ((++l->nHead) >= l->nHistory)
+                l->nHead            = 0;
+            for (size_t i=0; i<inputs; ++i)
+                dsp::fill_zero(&l->vHistory[i][l->nHead * step], step);
+        }
+
+        void IRConvolver::catch_up(level_t *l)
+        {
+            // Frames skipped before the pending one are lost, they are replaced by silence
+            const size_t dropped    = lsp_min(l->nDropped, l->nHistory);
+            for (size_t i=0; i<dropped; ++i)
+                push_silence(l, nInputs);
+            for (size_t i=dropped; i<l->nDropped; ++i)
+                if ((++l->nHead) >= l->nHistory)
+                    l->nHead            = 0;
+
+            // The pending frame gives the output for the next block as the job would do
+            l->fMorph           = fMorph;
+            transform(l, l->vPending, l->vOut, vAcc, vTemp);
+            l->nDropped         = 0;
+            l->bPending         = false;
+        }
+
+        void IRConvolver::delay_inputs(const float **dst, const float * const *src, size_t count)
+        {
+            // The delay line keeps enough samples to store the whole chunk before reading
+            const size_t size   = nDelay + DELAY_BLOCK;
+            size_t rpos         = nDelayPos + DELAY_BLOCK;
+            if (rpos >= size)
+                rpos               -= size;
+
+            for (size_t i=0; i<nInputs; ++i)
+            {
+                ring_write(vDelay[i], size, nDelayPos, src[i], count);
+                ring_read(vDelayed[i], vDelay[i], size, rpos, count);
+                dst[i]              = vDelayed[i];
+            }
+
+            nDelayPos          += count;
+            if (nDelayPos >= size)
+                nDelayPos          -= size;
+        }
+
+        void IRConvolver::process_tail(float * const *dst, const float * const *src, size_t count)
+        {
+            const float *in[CHANNELS_MAX];
+            for (size_t i=0; i<nInputs; ++i)
+                in[i]               = vTailIn[i];
+
+            for (size_t offset=0; offset < count; )
+            {
+                const size_t to_do  = lsp_min(count - offset, IRResampler::BLOCK_SIZE);
+
+                size_t n            = 0;
+                for (size_t i=0; i<nInputs; ++i)
+                    n                   = vDown[i]->downsample(vTailIn[i], &src[i][offset], to_do);
+                pTail->process(vTailOut, in, n);
+                for (size_t i=0; i<nOutputs; ++i)
+                    vUp[i]->upsample(&dst[i][offset], vTailOut[i], to_do);
+
+                offset             += to_do;
+            }
+        }
+
+        void IRConvolver::set_synth(IRFdn * const *synth)
+        {
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                IRFdn *fdn      = synth[i];
+                if (fdn == NULL)
+                    continue;
+                vSynth[i]       = fdn;
+                nLength         = lsp_max(nLength, fdn->length());
+                ++nSynth;
+            }
+        }
+
+        float IRConvolver::synth_error() const
+        {
+            if (nSynth <= 0)
+                return 0.0f;
+
+            float error     = 0.0f;
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+                if (vSynth[i] != NULL)
+                    error          += vSynth[i]->error();
+            return error / nSynth;
+        }
+
+        bool IRConvolver::prepare(IRPool *pool)
+        {
+            // Select the kernel with the least number of ready levels
+            IRKernel *next      = NULL;
+            size_t ready        = 0;
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX * 2; ++i)
+            {
+                IRKernel *k         = (i & 1) ? vMorph[i >> 1] : vKernels[i >> 1];
+                if ((k == NULL) || (k->prepared()))
+                    continue;
+                if ((next == NULL) || (k->ready() < ready))
+                {
+                    next                = k;
+                    ready               = k->ready();
+                }
+            }
+
+            if (next != NULL)
+                return next->prepare(pool);
+            return (pTail != NULL) ? pTail->prepare(pool) : true;
+        }
+
+        bool IRConvolver::prepared() const
+        {
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                if ((vKernels[i] != NULL) && (!vKernels[i]->prepared()))
+                    return false;
+                if ((vMorph[i] != NULL) && (!vMorph[i]->prepared()))
+                    return false;
+            }
+            return (pTail == NULL) || (pTail->prepared());
+        }
+
+        size_t IRConvolver::size() const
+        {
+            size_t bytes    = nSize;
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+            {
+                if (vKernels[i] != NULL)
+                    bytes          += vKernels[i]->size();
+                if (vMorph[i] != NULL)
+                    bytes          += vMorph[i]->size();
+                if (vSynth[i] != NULL)
+                    bytes          += vSynth[i]->size();
+            }
+            if (pTail != NULL)
+                bytes          += pTail->size();
+
+            return bytes;
+        }
+
+        void IRConvolver::process_synth(float * const *dst, const float * const *src, size_t count)
+        {
+            for (size_t i=0; i<nInputs; ++i)
+                for (size_t j=0; j<nOutputs; ++j)
+                {
+                    IRFdn *fdn      = vSynth[i * CHANNELS_MAX + j];
+                    if (fdn != NULL)
+                        fdn->process(dst[j], src[i], count);
+                }
+        }
+
+        void IRConvolver::clear()
+        {
+            for (size_t i=0; i<CHANNELS_MAX * CHANNELS_MAX; ++i)
+                if (vSynth[i] != NULL)
+                    vSynth[i]->clear();
+
+            if (pTail != NULL)
+            {
+                pTail->clear();
+                for (size_t i=0; i<nInputs; ++i)
+                    vDown[i]->clear();
+                for (size_t i=0; i<nOutputs; ++i)
+                    vUp[i]->clear();
+            }
+
+            for (size_t i=0; i<nOutputs; ++i)
+                dsp::fill_zero(vDirect[i], DIRECT_SIZE);
+            if (nDelay > 0)
+            {
+                for (size_t i=0; i<nInputs; ++i)
+                    dsp::fill_zero(vDelay[i], nDelay + DELAY_BLOCK);
+            }
+
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                level_t *l          = &vLevels[i];
+                const size_t b      = l->nBlock;
+
+                // Cancel the job, it delivers silence at the next deadline. The level which is
+                // still processed by the worker is cleared when the worker releases it
+                LevelJob *job       = l->pJob;
+                if (job != NULL)
+                {
+                    l->nDropped         = 0;
+                    l->bPending         = false;
+                    if (job->cancel())
+                    {
+                        for (size_t j=0; j<nOutputs; ++j)
+                            dsp::fill_zero(job->vResult[j], b);
+                    }
+                    else
+                        l->bClear           = true;
+                }
+
+                for (size_t j=0; j<nInputs; ++j)
+                {
+                    dsp::fill_zero(l->vFrame[j], b * 2);
+                    if (!l->bClear)
+                        dsp::fill_zero(l->vHistory[j], l->nHistory * b * 4);
+                }
+                for (size_t j=0; j<nOutputs; ++j)
+                    dsp::fill_zero(l->vOut[j], b);
+            }
+        }
+
+        void IRConvolver::process(float *dst, const float *src, size_t count)
+        {
+            process(&dst, &src, count);
+        }
+
+        void IRConvolver::process(float * const *dst, const float * const *src, size_t count)
+        {
+            if (nInputs <= 0)
+            {
+                dsp::fill_zero(dst[0], count);
+                return;
+            }
+
+            float *out[CHANNELS_MAX];
+            const float *in[CHANNELS_MAX];
+            for (size_t i=0; i<nOutputs; ++i)
+                out[i]              = dst[i];
+            for (size_t i=0; i<nInputs; ++i)
+                in[i]               = src[i];
+            const size_t total  = count;
+            if ((bMorph) && (fHeadMorph != fMorph))
+                mix_heads();
+
+            while (count > 0)
+            {
+                // Do not cross the block boundary of any level
+                size_t to_do        = (nHead > 0) ? lsp_min(count, IRKernel::HEAD_SIZE) : count;
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    const level_t *l    = &vLevels[i];
+                    to_do               = lsp_min(to_do, l->nBlock - l->nFill);
+                }
+
+                // Apply the pure delay to inputs
+                const float *cin[CHANNELS_MAX];
+                if (nDelay > 0)
+                {
+                    to_do               = lsp_min(to_do, DELAY_BLOCK);
+                    delay_inputs(cin, in, to_do);
+                }
+                else
+                {
+                    for (size_t i=0; i<nInputs; ++i)
+                        cin[i]              = in[i];
+                }
+
+                // Process the direct head
+                for (size_t o=0; o<nOutputs; ++o)
+                {
+                    if (nHead <= 0)
+                    {
+                        dsp::fill_zero(out[o], to_do);
+                        continue;
+                    }
+
+                    float *acc          = vDirect[o];
+                    for (size_t i=0; i<nInputs; ++i)
+                    {
+                        const IRKernel *k   = vKernels[i * CHANNELS_MAX + o];
+                        if (k == NULL)
+                            continue;
+                        const float *head   = (vMixHead[i * CHANNELS_MAX + o] != NULL) ? vMixHead[i * CHANNELS_MAX + o] : k->head();
+                        dsp::convolve(acc, cin[i], head, nHead, to_do);
+                    }
+                    dsp::copy(out[o], acc, to_do);
+                    dsp::move(acc, &acc[to_do], DIRECT_SIZE - to_do);
+                    dsp::fill_zero(&acc[DIRECT_SIZE - to_do], to_do);
+                }
+
+                // Process levels
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    level_t *l          = &vLevels[i];
+                    const size_t b      = l->nBlock;
+
+                    for (size_t j=0; j<nInputs; ++j)
+                        dsp::copy(&l->vFrame[j][b + l->nFill], cin[j], to_do);
+                    for (size_t j=0; j<nOutputs; ++j)
+                        dsp::add2(out[j], &l->vOut[j][l->nFill], to_do);
+                    l->nFill           += to_do;
+                    if (l->nFill >= b)
+                        process_block(l);
+                }
+
+                // Update pointers
+                for (size_t i=0; i<nOutputs; ++i)
+                    out[i]             += to_do;
+                for (size_t i=0; i<nInputs; ++i)
+                    in[i]              += to_do;
+                count              -= to_do;
+            }
+
+            // Add the output of the tail
+            if (pTail != NULL)
+                process_tail(dst, src, total);
+
+            // Add the synthesized tail
+            if (nSynth > 0)
+                process_synth(dst, src, total);
+        }
+
+        void IRConvolver::dump(dspu::IStateDumper *v) const
+        {
+            v->writev("vKernels", vKernels, CHANNELS_MAX * CHANNELS_MAX);
+            v->write("pWorker", pWorker);
+            v->write_object("pTail", pTail);
+            v->writev("vDown", vDown, CHANNELS_MAX);
+            v->writev("vUp", vUp, CHANNELS_MAX);
+            v->writev("vTailIn", vTailIn, CHANNELS_MAX);
+            v->writev("vTailOut", vTailOut, CHANNELS_MAX);
+            v->write("nFactor", nFactor);
+            v->write("fSaving", fSaving);
+            v->writev("vSynth", vSynth, CHANNELS_MAX * CHANNELS_MAX);
+            v->write("nSynth", nSynth);
+            v->writev("vMorph", vMorph, CHANNELS_MAX * CHANNELS_MAX);
+            v->writev("vMixHead", vMixHead, CHANNELS_MAX * CHANNELS_MAX);
+            v->write("fMorph", fMorph);
+            v->write("fHeadMorph", fHeadMorph);
+            v->write("bMorph", bMorph);
+            v->write("nInputs", nInputs);
+            v->write("nOutputs", nOutputs);
+            v->write("nLatency", nLatency);
+            v->write("nLength", nLength);
+            v->write("nDelay", nDelay);
+            v->write("nDelayPos", nDelayPos);
+            v->write("nHead", nHead);
+            v->write("nLevels", nLevels);
+            v->begin_array("vLevels", vLevels, nLevels);
+            {
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    const level_t *l = &vLevels[i];
+                    v->begin_object(l, sizeof(level_t));
+                    {
+                        v->write("nIndex", l->nIndex);
+                        v->write("nRank", l->nRank);
+                        v->write("nBlock", l->nBlock);
+                        v->write("nFirst", l->nFirst);
+                        v->write("nParts", l->nParts);
+                        v->writev("vFrame", l->vFrame, CHANNELS_MAX);
+                        v->writev("vOut", l->vOut, CHANNELS_MAX);
+                        v->writev("vHistory", l->vHistory, CHANNELS_MAX);
+                        v->write("nHistory", l->nHistory);
+                        v->write("nHead", l->nHead);
+                        v->write("nFill", l->nFill);
+                        v->write("nLag", l->nLag);
+                        v->write("fMorph", l->fMorph);
+                        v->write_object("pJob", static_cast<const IRJob *>(l->pJob));
+                        v->writev("vPending", l->vPending, CHANNELS_MAX);
+                        v->write("nDropped", l->nDropped);
+                        v->write("bPending", l->bPending);
+                        v->write("bClear", l->bClear);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->writev("vDirect", vDirect, CHANNELS_MAX);
+            v->writev("vDelay", vDelay, CHANNELS_MAX);
+            v->writev("vDelayed", vDelayed, CHANNELS_MAX);
+            v->write("vAcc", vAcc);
+            v->write("vTemp", vTemp);
+            v->write("nMisses", nMisses);
+            v->write("nSkips", nSkips);
+            v->write("nSize", nSize);
+            v->write("pArena", pArena);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
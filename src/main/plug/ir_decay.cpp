@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_decay.h>
+
+#include <lsp-plug.in/stdlib/math.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr double T20_BEGIN       = -5.0;     // Start of the fit range (dB)
+        static constexpr double T20_END         = -25.0;    // End of the fit range (dB)
+
+        typedef struct line_fit_t
+        {
+            double              sx, sy, sxx, sxy;
+            size_t              n;
+        } line_fit_t;
+
+        static inline double db_to_energy(double db)
+        {
+            return pow(10.0, db * 0.1);
+        }
+
+        static inline void fit_add(line_fit_t *f, double y)
+        {
+            const double x          = double(f->n);
+            f->sx                  += x;
+            f->sy                  += y;
+            f->sxx                 += x * x;
+            f->sxy                 += x * y;
+            ++f->n;
+        }
+
+        static float fit_rt60(const line_fit_t *f, size_t sample_rate)
+        {
+            // Estimate the reverberation time from the slope of the fit (dB per sample)
+            if (f->n < 2)
+                return 0.0f;
+            const double den        = f->n * f->sxx - f->sx * f->sx;
+            if (den <= 0.0)
+                return 0.0f;
+            const double slope      = (f->n * f->sxy - f->sx * f->sy) / den;
+            if (slope >= 0.0)
+                return 0.0f;
+
+            return float(-60.0 / (slope * double(sample_rate)));
+        }
+
+        void analyze_decay(ir_decay_t *res, const dspu::Sample *s, float threshold, size_t sample_rate)
+        {
+            const size_t length     = s->length();
+            const size_t channels   = s->channels();
+            res->nLength            = length;
+            res->fRT60              = 0.0f;
+
+            // Compute the total energy
+            double total            = 0.0;
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *src        = s->channel(i);
+                for (size_t j=0; j<length; ++j)
+                    total                  += double(src[j]) * double(src[j]);
+            }
+            if (total <= 0.0)
+                return;
+
+            // The decay curve is the energy remaining after the sample, walk it forward
+            const double e_trim     = total * db_to_energy(threshold);
+            const double e_begin    = total * db_to_energy(T20_BEGIN);
+            const double e_end      = total * db_to_energy(T20_END);
+            double remaining        = total;
+            line_fit_t fit          = { 0.0, 0.0, 0.0, 0.0, 0 };
+            bool trimmed            = false;
+
+            for (size_t j=0; j<length; ++j)
+            {
+                // Accumulate points of the linear fit
+                if ((remaining <= e_begin) && (remaining >= e_end))
+                    fit_add(&fit, 10.0 * log10(remaining / total));
+
+                // Find the first sample where the decay curve falls below the threshold
+                if ((!trimmed) && (remaining < e_trim))
+                {
+                    res->nLength            = lsp_max(j, size_t(1));
+                    trimmed                 = true;
+                }
+                if ((trimmed) && (remaining < e_end))
+                    break;
+
+                for (size_t i=0; i<channels; ++i)
+                {
+                    const float v           = s->channel(i)[j];
+                    remaining              -= double(v) * double(v);
+                }
+            }
+
+            res->fRT60              = fit_rt60(&fit, sample_rate);
+        }
+
+        float decay_time(const float *src, size_t length, size_t sample_rate)
+        {
+            double total            = 0.0;
+            for (size_t j=0; j<length; ++j)
+                total                  += double(src[j]) * double(src[j]);
+            if (total <= 0.0)
+                return 0.0f;
+
+            const double e_begin    = total * db_to_energy(T20_BEGIN);
+            const double e_end      = total * db_to_energy(T20_END);
+            double remaining        = total;
+            line_fit_t fit          = { 0.0, 0.0, 0.0, 0.0, 0 };
+
+            for (size_t j=0; (j<length) && (remaining >= e_end); ++j)
+            {
+                if (remaining <= e_begin)
+                    fit_add(&fit, 10.0 * log10(remaining / total));
+                remaining              -= double(src[j]) * double(src[j]);
+            }
+
+            return fit_rt60(&fit, sample_rate);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,681 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_disk_cache.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/io/Dir.h>
+#include <lsp-plug.in/io/NativeFile.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/runtime/system.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t HASH_BUF_SIZE       = 0x10000;
+        static constexpr uint32_t CACHE_VERSION     = 3;
+        static constexpr uint64_t FNV_OFFSET        = 0xcbf29ce484222325ULL;
+        static constexpr uint64_t FNV_PRIME         = 0x100000001b3ULL;
+        static constexpr wsize_t CACHE_LIMIT        = wsize_t(512) << 20;   // Maximum total size of entries (bytes)
+        static constexpr wsize_t STALE_TIME         = 10 * 60 * 1000;       // Age of the abandoned temporary file (ms)
+        static constexpr size_t TEMP_ATTEMPTS       = 16;                   // Number of attempts to create the temporary file
+        static constexpr size_t ENTRIES_MAX         = 0x400;                // Maximum number of entries considered for eviction
+
+        static uatomic_t temp_counter               = 0;
+
+        typedef struct header_t
+        {
+            char                    sMagic[4];      // Magic: 'IRDC'
+            uint32_t                nVersion;       // Version of the format
+            IRDiskCache::key_t      sKey;           // The key of the entry
+            uint32_t                nChannels;      // Number of channels
+            uint32_t                nLength;        // Length of each channel in samples
+            IRDiskCache::info_t     sInfo;          // Additional information
+        } header_t;
+
+        static_assert((sizeof(header_t) % DEFAULT_ALIGN) == 0, "Header size should be aligned");
+
+        typedef struct kernel_key_t
+        {
+            uint64_t                nHash;          // Hash of the kernel parameters
+            uint64_t                nSampleRate;    // Sample rate
+            uint64_t                nRank;          // Maximum FFT rank
+            uint64_t                nLatency;       // Latency
+        } kernel_key_t;
+
+        typedef struct kernel_header_t
+        {
+            char                    sMagic[4];      // Magic: 'IRDK'
+            uint32_t                nVersion;       // Version of the format
+            kernel_key_t            sKey;           // The key of the entry
+            IRKernel::image_t       sImage;         // Layout of the kernel
+        } kernel_header_t;
+
+        // The data block follows the header at the aligned offset
+        static const size_t KERNEL_DATA_OFFSET      = align_size(sizeof(kernel_header_t), DEFAULT_ALIGN);
+
+        typedef struct lru_entry_t
+        {
+            LSPString               sName;          // Name of the file
+            wsize_t                 nSize;          // Size of the file
+            wsize_t                 nTime;          // Last access or modification time
+        } lru_entry_t;
+
+        /**
+         * Read-only memory-mapped file the kernel is attached to
+         */
+        class MappedFile: public IRKernel::Storage
+        {
+            private:
+            #ifdef PLATFORM_WINDOWS
+                HANDLE              hFile;
+                HANDLE              hMapping;
+            #endif /* PLATFORM_WINDOWS */
+                uint8_t            *pData;
+                size_t              nSize;
+
+            public:
+                MappedFile()
+                {
+                #ifdef PLATFORM_WINDOWS
+                    hFile       = INVALID_HANDLE_VALUE;
+                    hMapping    = NULL;
+                #endif /* PLATFORM_WINDOWS */
+                    pData       = NULL;
+                    nSize       = 0;
+                }
+
+                virtual ~MappedFile() override
+                {
+                    close();
+                }
+
+            public:
+                status_t open(const io::Path *path)
+                {
+                #ifdef PLATFORM_WINDOWS
+                    const WCHAR *wpath  = reinterpret_cast<const WCHAR *>(path->as_string()->get_utf16());
+                    if (wpath == NULL)
+                        return STATUS_NO_MEM;
+                    hFile       = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+                    if (hFile == INVALID_HANDLE_VALUE)
+                        return STATUS_NOT_FOUND;
+                    LARGE_INTEGER size;
+                    if ((!GetFileSizeEx(hFile, &size)) || (size.QuadPart <= 0) || (uint64_t(size.QuadPart) > SIZE_MAX))
+                        return STATUS_CORRUPTED;
+                    hMapping    = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+                    if (hMapping == NULL)
+                        return STATUS_IO_ERROR;
+                    void *addr  = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+                    if (addr == NULL)
+                        return STATUS_IO_ERROR;
+                    nSize       = size.QuadPart;
+                #else
+                    const int fd    = ::open(path->as_native(), O_RDONLY | O_CLOEXEC);
+                    if (fd < 0)
+                        return STATUS_NOT_FOUND;
+                    lsp_finally { ::close(fd); };
+                    struct stat st;
+                    if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+                        return STATUS_CORRUPTED;
+                    void *addr  = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (addr == MAP_FAILED)
+                        return STATUS_IO_ERROR;
+                    nSize       = st.st_size;
+                #endif /* PLATFORM_WINDOWS */
+
+                    pData       = static_cast<uint8_t *>(addr);
+                    return STATUS_OK;
+                }
+
+                void close()
+                {
+                #ifdef PLATFORM_WINDOWS
+                    if (pData != NULL)
+                        UnmapViewOfFile(pData);
+                    if (hMapping != NULL)
+                        CloseHandle(hMapping);
+                    if (hFile != INVALID_HANDLE_VALUE)
+                        CloseHandle(hFile);
+                    hFile       = INVALID_HANDLE_VALUE;
+                    hMapping    = NULL;
+                #else
+                    if (pData != NULL)
+                        munmap(pData, nSize);
+                #endif /* PLATFORM_WINDOWS */
+                    pData       = NULL;
+                    nSize       = 0;
+                }
+
+                inline const uint8_t *data() const  { return pData; }
+                inline size_t size() const          { return nSize; }
+        };
+
+        static inline uint64_t fnv1a(uint64_t hash, const void *data, size_t count)
+        {
+            const uint8_t *p = static_cast<const uint8_t *>(data);
+            for (size_t i=0; i<count; ++i)
+                hash    = (hash ^ p[i]) * FNV_PRIME;
+            return hash;
+        }
+
+        static inline size_t stride(size_t length)
+        {
+            return align_size(length * sizeof(float), DEFAULT_ALIGN);
+        }
+
+        static status_t read_fully(io::File *fd, void *dst, size_t count)
+        {
+            uint8_t *ptr = static_cast<uint8_t *>(dst);
+            while (count > 0)
+            {
+                const ssize_t n = fd->read(ptr, count);
+                if (n <= 0)
+                    return (n < 0) ? status_t(-n) : STATUS_CORRUPTED;
+                ptr    += n;
+                count  -= n;
+            }
+            return STATUS_OK;
+        }
+
+        static status_t write_fully(io::File *fd, const void *src, size_t count)
+        {
+            const uint8_t *ptr = static_cast<const uint8_t *>(src);
+            while (count > 0)
+            {
+                const ssize_t n = fd->write(ptr, count);
+                if (n <= 0)
+                    return (n < 0) ? status_t(-n) : STATUS_IO_ERROR;
+                ptr    += n;
+                count  -= n;
+            }
+            return STATUS_OK;
+        }
+
+        static status_t get_cache_root(io::Path *path)
+        {
+            status_t res;
+            LSPString dir;
+
+        #if defined(PLATFORM_WINDOWS)
+            // The local application data is accessible by the owner only
+            if ((system::get_env_var("LOCALAPPDATA", &dir) == STATUS_OK) && (!dir.is_empty()))
+                return path->set(&dir);
+            return system::get_user_config_path(path);
+        #elif defined(PLATFORM_MACOSX)
+            if ((res = system::get_home_directory(path)) != STATUS_OK)
+                return res;
+            if ((res = path->append_child("Library")) != STATUS_OK)
+                return res;
+            return path->append_child("Caches");
+        #else
+            // The XDG base directory should be absolute, otherwise it is ignored
+            if ((system::get_env_var("XDG_CACHE_HOME", &dir) == STATUS_OK) && (dir.starts_with('/')))
+                return path->set(&dir);
+            if ((res = system::get_home_directory(path)) != STATUS_OK)
+                return res;
+            return path->append_child(".cache");
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        static status_t make_private_dir(const io::Path *path)
+        {
+        #ifdef PLATFORM_WINDOWS
+            // Directories inherit the access list of the user profile
+            return path->mkdir(true);
+        #else
+            // Entries of the cache are loaded without validation of the data, so the directory
+            // should be owned by the user and should not be accessible by anyone else
+            const char *native = path->as_native();
+            if (native == NULL)
+                return STATUS_NO_MEM;
+            if ((::mkdir(native, S_IRWXU) != 0) && (errno != EEXIST))
+                return STATUS_IO_ERROR;
+
+            struct stat st;
+            if (::lstat(native, &st) != 0)
+                return STATUS_IO_ERROR;
+            if ((!S_ISDIR(st.st_mode)) || (st.st_uid != ::geteuid()))
+                return STATUS_PERMISSION_DENIED;
+            if (((st.st_mode & (S_IRWXG | S_IRWXO)) != 0) && (::chmod(native, S_IRWXU) != 0))
+                return STATUS_PERMISSION_DENIED;
+
+            return STATUS_OK;
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        IRDiskCache::IRDiskCache()
+        {
+            bInit       = false;
+        }
+
+        IRDiskCache::~IRDiskCache()
+        {
+        }
+
+        void IRDiskCache::init_key(key_t *key)
+        {
+            // Zero all bytes including padding because the key is hashed as a plain memory
+            memset(key, 0, sizeof(key_t));
+        }
+
+        uint64_t IRDiskCache::digest(const void *data, size_t count)
+        {
+            return fnv1a(FNV_OFFSET, data, count);
+        }
+
+        status_t IRDiskCache::hash_file(uint64_t *hash, const char *path)
+        {
+            io::NativeFile fd;
+            status_t res = fd.open(path, io::File::FM_READ);
+            if (res != STATUS_OK)
+                return res;
+            lsp_finally { fd.close(); };
+
+            uint8_t *buf = static_cast<uint8_t *>(malloc(HASH_BUF_SIZE));
+            if (buf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free(buf); };
+
+            uint64_t h = FNV_OFFSET;
+            while (true)
+            {
+                const ssize_t n = fd.read(buf, HASH_BUF_SIZE);
+                if (n <= 0)
+                {
+                    if ((n < 0) && (status_t(-n) != STATUS_EOF))
+                        return status_t(-n);
+                    break;
+                }
+                h       = fnv1a(h, buf, n);
+            }
+
+            *hash   = h;
+            return STATUS_OK;
+        }
+
+        status_t IRDiskCache::init()
+        {
+            status_t res;
+            bInit       = false;
+
+            // The cache is kept in the cache directory of the user, the shared temporary directory
+            // would allow other users to substitute entries
+            if ((res = get_cache_root(&sBase)) != STATUS_OK)
+                return res;
+            if ((res = sBase.mkdir(true)) != STATUS_OK)
+                return res;
+            if ((res = sBase.append_child("lsp-plugins")) != STATUS_OK)
+                return res;
+            if ((res = make_private_dir(&sBase)) != STATUS_OK)
+                return res;
+            if ((res = sBase.append_child("impulse_responses")) != STATUS_OK)
+                return res;
+            if ((res = make_private_dir(&sBase)) != STATUS_OK)
+                return res;
+
+            bInit       = true;
+            return STATUS_OK;
+        }
+
+        status_t IRDiskCache::get_location(io::Path *path, const void *key, size_t bytes, const char *ext) const
+        {
+            status_t res;
+            if (!bInit)
+                return STATUS_BAD_STATE;
+
+            // Form the file name from the key
+            char fname[32];
+            const uint64_t h = fnv1a(FNV_OFFSET, key, bytes);
+            snprintf(fname, sizeof(fname), "%016llx.%s", (unsigned long long)(h), ext);
+
+            if ((res = path->set(&sBase)) != STATUS_OK)
+                return res;
+            return path->append_child(fname);
+        }
+
+        status_t IRDiskCache::create_temporary(io::NativeFile *fd, io::Path *path, const io::Path *dst) const
+        {
+            // Several instances and processes can store the same entry at the same time,
+            // so each of them writes its own file which should not exist
+            char suffix[48];
+            status_t res        = STATUS_IO_ERROR;
+            for (size_t i=0; i<TEMP_ATTEMPTS; ++i)
+            {
+                const uint64_t seed = uint64_t(system::get_time_millis()) ^ uint64_t(uintptr_t(this)) ^
+                    (uint64_t(atomic_add(&temp_counter, uatomic_t(1))) << 40);
+                snprintf(suffix, sizeof(suffix), ".%016llx.tmp", (unsigned long long)(fnv1a(FNV_OFFSET, &seed, sizeof(seed))));
+
+                if ((res = path->set(dst)) != STATUS_OK)
+                    return res;
+                if ((res = path->concat(suffix)) != STATUS_OK)
+                    return res;
+                res = fd->open(path, io::File::FM_WRITE | io::File::FM_CREATE | io::File::FM_EXCL);
+                if (res != STATUS_ALREADY_EXISTS)
+                    return res;
+            }
+
+            return res;
+        }
+
+        status_t IRDiskCache::commit(io::NativeFile *fd, const io::Path *tmp, const io::Path *dst, status_t res) const
+        {
+            const status_t cres = fd->close();
+            if (res == STATUS_OK)
+                res     = cres;
+
+            // Publish the complete entry atomically, only the own temporary file is removed on error
+            if (res == STATUS_OK)
+                res     = tmp->rename(dst);
+            if (res != STATUS_OK)
+            {
+                tmp->remove();
+                return res;
+            }
+
+            trim();
+            return STATUS_OK;
+        }
+
+        void IRDiskCache::trim() const
+        {
+            io::Dir dir;
+            if (dir.open(&sBase) != STATUS_OK)
+                return;
+            lsp_finally { dir.close(); };
+
+            // Collect entries, remove temporary files abandoned by crashed processes
+            lru_entry_t *list   = new lru_entry_t[ENTRIES_MAX];
+            if (list == NULL)
+                return;
+            lsp_finally { delete [] list; };
+
+            const wsize_t now   = system::get_time_millis();
+            wsize_t total       = 0;
+            size_t count        = 0;
+            LSPString name;
+            io::fattr_t attr;
+            io::Path path;
+            while (dir.reads(&name, &attr, false) == STATUS_OK)
+            {
+                if (attr.type != io::fattr_t::FT_REGULAR)
+                    continue;
+
+                if (name.ends_with_ascii(".tmp"))
+                {
+                    if ((attr.mtime + STALE_TIME < now) &&
+                        (path.set(&sBase) == STATUS_OK) &&
+                        (path.append_child(&name) == STATUS_OK))
+                        path.remove();
+                    continue;
+                }
+                if ((!name.ends_with_ascii(".irc")) && (!name.ends_with_ascii(".irk")))
+                    continue;
+
+                total              += attr.size;
+                if (count >= ENTRIES_MAX)
+                    continue;
+
+                lru_entry_t *e      = &list[count++];
+                if (!e->sName.set(&name))
+                    return;
+                e->nSize            = attr.size;
+                e->nTime            = lsp_max(attr.atime, attr.mtime);
+            }
+
+            // Remove the least recently used entries until the total size fits the limit
+            while ((total > CACHE_LIMIT) && (count > 0))
+            {
+                size_t oldest       = 0;
+                for (size_t i=1; i<count; ++i)
+                    if (list[i].nTime < list[oldest].nTime)
+                        oldest              = i;
+
+                lru_entry_t *e      = &list[oldest];
+                if ((path.set(&sBase) == STATUS_OK) &&
+                    (path.append_child(&e->sName) == STATUS_OK) &&
+                    (path.remove() == STATUS_OK))
+                {
+                    lsp_trace("Evicted disk cache entry %s", path.as_utf8());
+                    total              -= e->nSize;
+                }
+
+                e->sName.swap(&list[--count].sName);
+                e->nSize            = list[count].nSize;
+                e->nTime            = list[count].nTime;
+            }
+        }
+
+        status_t IRDiskCache::load(dspu::Sample **dst, info_t *info, const key_t *key) const
+        {
+            io::Path path;
+            status_t res = get_location(&path, key, sizeof(key_t), "irc");
+            if (res != STATUS_OK)
+                return res;
+            if (!path.exists())
+                return STATUS_NOT_FOUND;
+
+            io::NativeFile fd;
+            if ((res = fd.open(&path, io::File::FM_READ)) != STATUS_OK)
+                return STATUS_NOT_FOUND;
+            lsp_finally { fd.close(); };
+
+            // Read and validate header, the entry may belong to other key in case of hash collision
+            header_t hdr;
+            if ((res = read_fully(&fd, &hdr, sizeof(hdr))) != STATUS_OK)
+                return res;
+            if ((memcmp(hdr.sMagic, "IRDC", 4) != 0) || (hdr.nVersion != CACHE_VERSION))
+                return STATUS_BAD_FORMAT;
+            if (memcmp(&hdr.sKey, key, sizeof(key_t)) != 0)
+                return STATUS_NOT_FOUND;
+            if ((hdr.nChannels <= 0) || (hdr.nLength <= 0))
+                return STATUS_CORRUPTED;
+
+            // Validate the size of the file before allocating memory for the data
+            const wssize_t fsize    = fd.size();
+            if (fsize < 0)
+                return status_t(-fsize);
+            const wsize_t payload   = wsize_t(fsize) - lsp_min(wsize_t(fsize), wsize_t(sizeof(header_t)));
+            const wsize_t cstride   = (wsize_t(hdr.nLength) * sizeof(float) + DEFAULT_ALIGN - 1) & ~wsize_t(DEFAULT_ALIGN - 1);
+            if ((hdr.nChannels > payload / cstride) || (payload != wsize_t(hdr.nChannels) * cstride))
+                return STATUS_CORRUPTED;
+
+            // Allocate sample and read data
+            dspu::Sample *s     = new dspu::Sample();
+            if (s == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally {
+                if (s != NULL)
+                {
+                    s->destroy();
+                    delete s;
+                }
+            };
+            if (!s->init(hdr.nChannels, hdr.nLength, hdr.nLength))
+                return STATUS_NO_MEM;
+
+            const size_t bytes  = hdr.nLength * sizeof(float);
+            const size_t pad    = stride(hdr.nLength) - bytes;
+            uint8_t padding[DEFAULT_ALIGN];
+            for (size_t i=0; i<hdr.nChannels; ++i)
+            {
+                if ((res = read_fully(&fd, s->channel(i), bytes)) != STATUS_OK)
+                    return res;
+                if ((pad > 0) && ((res = read_fully(&fd, padding, pad)) != STATUS_OK))
+                    return res;
+            }
+
+            // Return the result
+            *info   = hdr.sInfo;
+            *dst    = s;
+            s       = NULL;
+
+            return STATUS_OK;
+        }
+
+        status_t IRDiskCache::store(const dspu::Sample *s, const info_t *info, const key_t *key) const
+        {
+            if ((s == NULL) || (s->channels() <= 0) || (s->length() <= 0))
+                return STATUS_BAD_ARGUMENTS;
+
+            io::Path path, tmp;
+            status_t res = get_location(&path, key, sizeof(key_t), "irc");
+            if (res != STATUS_OK)
+                return res;
+
+            io::NativeFile fd;
+            if ((res = create_temporary(&fd, &tmp, &path)) != STATUS_OK)
+                return res;
+
+            // Form the header
+            header_t hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            memcpy(hdr.sMagic, "IRDC", 4);
+            hdr.nVersion        = CACHE_VERSION;
+            hdr.sKey            = *key;
+            hdr.nChannels       = s->channels();
+            hdr.nLength         = s->length();
+            hdr.sInfo           = *info;
+
+            // Write header and data
+            const size_t bytes  = hdr.nLength * sizeof(float);
+            const size_t pad    = stride(hdr.nLength) - bytes;
+            uint8_t padding[DEFAULT_ALIGN];
+            memset(padding, 0, sizeof(padding));
+
+            res = write_fully(&fd, &hdr, sizeof(hdr));
+            for (size_t i=0; (res == STATUS_OK) && (i<hdr.nChannels); ++i)
+            {
+                res = write_fully(&fd, s->channel(i), bytes);
+                if ((res == STATUS_OK) && (pad > 0))
+                    res = write_fully(&fd, padding, pad);
+            }
+
+            return commit(&fd, &tmp, &path, res);
+        }
+
+        static void make_kernel_key(kernel_key_t *dst, const IRRegistry::kernel_key_t *key)
+        {
+            // Zero all bytes including padding because the key is hashed as a plain memory
+            memset(dst, 0, sizeof(kernel_key_t));
+            dst->nHash          = key->nHash;
+            dst->nSampleRate    = key->nSampleRate;
+            dst->nRank          = key->nRank;
+            dst->nLatency       = key->nLatency;
+        }
+
+        status_t IRDiskCache::load_kernel(IRKernel **dst, const IRRegistry::kernel_key_t *key) const
+        {
+            kernel_key_t k_key;
+            make_kernel_key(&k_key, key);
+
+            io::Path path;
+            status_t res = get_location(&path, &k_key, sizeof(k_key), "irk");
+            if (res != STATUS_OK)
+                return res;
+            if (!path.exists())
+                return STATUS_NOT_FOUND;
+
+            // Map the file, the mapping stays valid even if the entry is replaced or evicted
+            MappedFile *mf      = new MappedFile();
+            if (mf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally {
+                if (mf != NULL)
+                    delete mf;
+            };
+            if ((res = mf->open(&path)) != STATUS_OK)
+                return res;
+
+            // Validate header, the entry may belong to other key in case of hash collision
+            if (mf->size() < KERNEL_DATA_OFFSET)
+                return STATUS_CORRUPTED;
+            const kernel_header_t *hdr = reinterpret_cast<const kernel_header_t *>(mf->data());
+            if ((memcmp(hdr->sMagic, "IRDK", 4) != 0) || (hdr->nVersion != CACHE_VERSION))
+                return STATUS_BAD_FORMAT;
+            if (memcmp(&hdr->sKey, &k_key, sizeof(k_key)) != 0)
+                return STATUS_NOT_FOUND;
+
+            // Attach the kernel to the mapped data
+            IRKernel *k         = new IRKernel();
+            if (k == NULL)
+                return STATUS_NO_MEM;
+            if (!k->attach(&hdr->sImage, &mf->data()[KERNEL_DATA_OFFSET], mf->size() - KERNEL_DATA_OFFSET, mf))
+            {
+                IRKernel::release(k);
+                return STATUS_CORRUPTED;
+            }
+
+            *dst    = k;
+            mf      = NULL;
+
+            return STATUS_OK;
+        }
+
+        status_t IRDiskCache::store_kernel(const IRKernel *k, const IRRegistry::kernel_key_t *key) const
+        {
+            // Form the header
+            kernel_header_t hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            const void *data    = (k != NULL) ? k->export_image(&hdr.sImage) : NULL;
+            if (data == NULL)
+                return STATUS_BAD_ARGUMENTS;
+            memcpy(hdr.sMagic, "IRDK", 4);
+            hdr.nVersion        = CACHE_VERSION;
+            make_kernel_key(&hdr.sKey, key);
+
+            io::Path path, tmp;
+            status_t res = get_location(&path, &hdr.sKey, sizeof(hdr.sKey), "irk");
+            if (res != STATUS_OK)
+                return res;
+
+            io::NativeFile fd;
+            if ((res = create_temporary(&fd, &tmp, &path)) != STATUS_OK)
+                return res;
+
+            // Write header, padding and data
+            uint8_t padding[DEFAULT_ALIGN];
+            memset(padding, 0, sizeof(padding));
+
+            res = write_fully(&fd, &hdr, sizeof(hdr));
+            if (res == STATUS_OK)
+                res = write_fully(&fd, padding, KERNEL_DATA_OFFSET - sizeof(hdr));
+            if (res == STATUS_OK)
+                res = write_fully(&fd, data, hdr.sImage.nSize);
+
+            return commit(&fd, &tmp, &path, res);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
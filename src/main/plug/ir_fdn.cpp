@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_decay.h>
+#include <private/plugins/ir_fdn.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        // Mutually prime lengths of delay lines (ms)
+        static const float LINE_TIMES[IRFdn::LINES] = { 13.1f, 16.7f, 19.9f, 23.3f, 27.7f, 31.1f, 36.7f, 41.3f };
+
+        static constexpr float TONE_FREQ            = 1000.0f;  // Crossover frequency between the low and the high band (Hz)
+        static constexpr float ERROR_FRAME          = 20.0f;    // Length of the frame to measure the spectral error (ms)
+        static constexpr float ERROR_RANGE          = 1e-6f;    // Frames below -60 dB of the loudest frame are not measured
+        static constexpr size_t FIT_PASSES          = 2;        // Number of passes to match the energy of bands
+
+        static inline size_t line_length(size_t index, size_t sample_rate)
+        {
+            return size_t(LINE_TIMES[index] * 0.001f * sample_rate + 0.5f);
+        }
+
+        static size_t pow2_size(size_t size)
+        {
+            size_t res          = 1;
+            while (res < size)
+                res               <<= 1;
+            return res;
+        }
+
+        static void split_bands(float *lo, float *hi, const float *src, size_t count, float k)
+        {
+            // Zero-phase low-pass filter: one-pole filter applied in both directions
+            float s             = 0.0f;
+            for (size_t i=0; i<count; ++i)
+            {
+                s                  += k * (src[i] - s);
+                lo[i]               = s;
+            }
+            s                   = 0.0f;
+            for (size_t i=count; i > 0; )
+            {
+                --i;
+                s                  += k * (lo[i] - s);
+                lo[i]               = s;
+                hi[i]               = src[i] - s;
+            }
+        }
+
+        static double energy(const float *src, size_t count)
+        {
+            double res          = 0.0;
+            for (size_t i=0; i<count; ++i)
+                res                += double(src[i]) * double(src[i]);
+            return res;
+        }
+
+        static void band_error(double *err, size_t *n, const float *ref, const float *src, size_t count, size_t frame)
+        {
+            double e_max        = 0.0;
+            for (size_t i=0; i<count; i += frame)
+                e_max               = lsp_max(e_max, energy(&ref[i], lsp_min(frame, count - i)));
+
+            const double thresh = e_max * ERROR_RANGE;
+            for (size_t i=0; i<count; i += frame)
+            {
+                const size_t to_do  = lsp_min(frame, count - i);
+                const double e_ref  = energy(&ref[i], to_do);
+                if ((e_ref <= 0.0) || (e_ref < thresh))
+                    continue;
+                const double e_src  = lsp_max(energy(&src[i], to_do), e_ref * ERROR_RANGE);
+                *err               += fabs(10.0 * log10(e_src / e_ref));
+                ++(*n);
+            }
+        }
+
+        IRFdn::IRFdn()
+        {
+            for (size_t i=0; i<LINES; ++i)
+            {
+                vLength[i]  = 0;
+                vGain[i]    = 0.0f;
+                vPole[i]    = 0.0f;
+                vState[i]   = 0.0f;
+            }
+            vLines      = NULL;
+            vPre        = NULL;
+            nLineSize   = 0;
+            nPreSize    = 0;
+            nPos        = 0;
+            nPrePos     = 0;
+            nPreDelay   = 0;
+            nLength     = 0;
+            fTone       = 0.0f;
+            fToneState  = 0.0f;
+            fLowGain    = 0.0f;
+            fHighGain   = 0.0f;
+            fLowRT60    = 0.0f;
+            fHighRT60   = 0.0f;
+            fError      = 0.0f;
+            pData       = NULL;
+        }
+
+        IRFdn::~IRFdn()
+        {
+            destroy();
+        }
+
+        void IRFdn::destroy()
+        {
+            free_aligned(pData);
+
+            vLines      = NULL;
+            vPre        = NULL;
+            nLineSize   = 0;
+            nPreSize    = 0;
+            nPos        = 0;
+            nPrePos     = 0;
+            nPreDelay   = 0;
+            nLength     = 0;
+            fError      = 0.0f;
+        }
+
+        size_t IRFdn::min_split(size_t sample_rate)
+        {
+            return line_length(0, sample_rate);
+        }
+
+        void IRFdn::set_decay(float low, float high, size_t sample_rate)
+        {
+            // The one-pole filter g * (1 - b) / (1 - b*z^-1) has the gain g at DC and the
+            // gain g * (1 - b) / (1 + b) at the Nyquist frequency
+            for (size_t i=0; i<LINES; ++i)
+            {
+                const float k0      = powf(10.0f, -3.0f * vLength[i] / (low * sample_rate));
+                const float kn      = powf(10.0f, -3.0f * vLength[i] / (high * sample_rate));
+                const float b       = (k0 - kn) / (k0 + kn);
+                vGain[i]            = k0 * (1.0f - b);
+                vPole[i]            = b;
+            }
+            fLowRT60            = low;
+            fHighRT60           = high;
+        }
+
+        inline float IRFdn::step(float x)
+        {
+            static constexpr float norm = 0.35355339059f;   // 1/sqrt(LINES)
+            const size_t mask   = nLineSize - 1;
+            float v[LINES];
+            float y             = 0.0f;
+
+            // Read and damp outputs of delay lines
+            for (size_t i=0; i<LINES; ++i)
+            {
+                const float s       = vLines[i * nLineSize + ((nPos - vLength[i]) & mask)];
+                const float f       = vGain[i] * s + vPole[i] * vState[i];
+                vState[i]           = f;
+                v[i]                = f;
+                y                  += (i & 1) ? -f : f;
+            }
+
+            // Mix delay lines by the fast Walsh-Hadamard transform and feed them back
+            for (size_t h=1; h<LINES; h <<= 1)
+                for (size_t i=0; i<LINES; i += h * 2)
+                    for (size_t j=i; j<i+h; ++j)
+                    {
+                        const float a       = v[j];
+                        const float b       = v[j + h];
+                        v[j]                = a + b;
+                        v[j + h]            = a - b;
+                    }
+            for (size_t i=0; i<LINES; ++i)
+                vLines[i * nLineSize + nPos]    = v[i] * norm + x;
+            nPos                = (nPos + 1) & mask;
+
+            // Apply the tone control
+            y                  *= norm;
+            fToneState         += fTone * (y - fToneState);
+            return fLowGain * fToneState + fHighGain * (y - fToneState);
+        }
+
+        void IRFdn::reset()
+        {
+            for (size_t i=0; i<LINES; ++i)
+                vState[i]           = 0.0f;
+            fToneState          = 0.0f;
+            nPos                = 0;
+            nPrePos             = 0;
+            dsp::fill_zero(vLines, nLineSize * LINES);
+            dsp::fill_zero(vPre, nPreSize);
+        }
+
+        void IRFdn::render(float *dst, size_t delay, size_t count)
+        {
+            reset();
+            dsp::fill_zero(dst, lsp_min(delay, count));
+            for (size_t i=delay; i<count; ++i)
+                dst[i]              = step((i == delay) ? 1.0f : 0.0f);
+        }
+
+        status_t IRFdn::fit(const float *ir, size_t length, size_t split, size_t latency, size_t sample_rate)
+        {
+            const size_t first  = line_length(0, sample_rate);
+            if ((split < first) || (length <= split))
+                return STATUS_BAD_ARGUMENTS;
+
+            // Allocate delay lines
+            size_t lengths[LINES];
+            for (size_t i=0; i<LINES; ++i)
+                lengths[i]          = line_length(i, sample_rate);
+            const size_t pre_delay  = split + latency - first;
+            const size_t line_size  = pow2_size(lengths[LINES - 1] + 1);
+            const size_t pre_size   = pow2_size(pre_delay + 1);
+
+            uint8_t *data       = NULL;
+            float *lines        = alloc_aligned<float>(data, line_size * LINES + pre_size, DEFAULT_ALIGN);
+            if (lines == NULL)
+                return STATUS_NO_MEM;
+
+            // Allocate temporary buffers for the analysis
+            const size_t tail   = length - split;
+            uint8_t *tmp_data   = NULL;
+            float *resp         = alloc_aligned<float>(tmp_data, length + tail * 4, DEFAULT_ALIGN);
+            if (resp == NULL)
+            {
+                free_aligned(data);
+                return STATUS_NO_MEM;
+            }
+            lsp_finally { free_aligned(tmp_data); };
+            float *ir_lo        = &resp[length];
+            float *ir_hi        = &ir_lo[tail];
+            float *r_lo         = &ir_hi[tail];
+            float *r_hi         = &r_lo[tail];
+
+            destroy();
+
+            for (size_t i=0; i<LINES; ++i)
+                vLength[i]          = lengths[i];
+            vLines              = lines;
+            vPre                = &lines[line_size * LINES];
+            nLineSize           = line_size;
+            nPreSize            = pre_size;
+            pData               = data;
+            fTone               = 1.0f - expf(-2.0f * M_PI * TONE_FREQ / sample_rate);
+
+            // Measure the reverberation time of bands of the tail
+            split_bands(ir_lo, ir_hi, &ir[split], tail, fTone);
+            float t_low         = decay_time(ir_lo, tail, sample_rate);
+            float t_high        = decay_time(ir_hi, tail, sample_rate);
+            if (t_low <= 0.0f)
+                t_low               = t_high;
+            if (t_high <= 0.0f)
+                t_high              = t_low;
+            if (t_low <= 0.0f)
+            {
+                destroy();
+                return STATUS_NO_DATA;
+            }
+            set_decay(t_low, t_high, sample_rate);
+
+            // Render the response and match the energy of bands, the second pass compensates
+            // the overlap of bands of the tone control
+            const double ei_lo  = energy(ir_lo, tail);
+            const double ei_hi  = energy(ir_hi, tail);
+            fLowGain            = 1.0f;
+            fHighGain           = 1.0f;
+            for (size_t pass=0; pass<FIT_PASSES; ++pass)
+            {
+                render(resp, split - first, length);
+                split_bands(r_lo, r_hi, &resp[split], tail, fTone);
+                const double e_lo   = energy(r_lo, tail);
+                const double e_hi   = energy(r_hi, tail);
+                fLowGain           *= (e_lo > 0.0) ? sqrt(ei_lo / e_lo) : 0.0f;
+                fHighGain          *= (e_hi > 0.0) ? sqrt(ei_hi / e_hi) : 0.0f;
+            }
+
+            // Render the fitted response and measure the spectral error of the fit
+            render(resp, split - first, length);
+            split_bands(r_lo, r_hi, &resp[split], tail, fTone);
+            const size_t frame  = lsp_max(size_t(ERROR_FRAME * 0.001f * sample_rate), size_t(1));
+            double err          = 0.0;
+            size_t n            = 0;
+            band_error(&err, &n, ir_lo, r_lo, tail, frame);
+            band_error(&err, &n, ir_hi, r_hi, tail, frame);
+            fError              = (n > 0) ? float(err / n) : 0.0f;
+
+            // Prepare for processing
+            reset();
+            nPreDelay           = pre_delay;
+            nLength             = length + latency;
+
+            return STATUS_OK;
+        }
+
+        void IRFdn::clear()
+        {
+            if (vLines != NULL)
+                reset();
+        }
+
+        void IRFdn::process(float *dst, const float *src, size_t count)
+        {
+            const size_t mask   = nPreSize - 1;
+            for (size_t i=0; i<count; ++i)
+            {
+                vPre[nPrePos]       = src[i];
+                const float x       = vPre[(nPrePos - nPreDelay) & mask];
+                nPrePos             = (nPrePos + 1) & mask;
+                dst[i]             += step(x);
+            }
+        }
+
+        void IRFdn::dump(dspu::IStateDumper *v) const
+        {
+            v->writev("vLength", vLength, LINES);
+            v->writev("vGain", vGain, LINES);
+            v->writev("vPole", vPole, LINES);
+            v->writev("vState", vState, LINES);
+            v->write("vLines", vLines);
+            v->write("vPre", vPre);
+            v->write("nLineSize", nLineSize);
+            v->write("nPreSize", nPreSize);
+            v->write("nPos", nPos);
+            v->write("nPrePos", nPrePos);
+            v->write("nPreDelay", nPreDelay);
+            v->write("nLength", nLength);
+            v->write("fTone", fTone);
+            v->write("fToneState", fToneState);
+            v->write("fLowGain", fLowGain);
+            v->write("fHighGain", fHighGain);
+            v->write("fLowRT60", fLowRT60);
+            v->write("fHighRT60", fHighRT60);
+            v->write("fError", fError);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,544 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_kernel.h>
+#include <private/plugins/ir_registry.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t MAX_RANK        = 16;
+
+        static_assert((size_t(1) << MAX_RANK) <= IRPool::SCRATCH_SIZE, "Scratch buffer of the pool does not fit partition");
+
+        static inline size_t block_rank(size_t block)
+        {
+            size_t rank = 0;
+            while (block > 1)
+            {
+                block     >>= 1;
+                ++rank;
+            }
+            return rank;
+        }
+
+        IRKernel::Storage::~Storage()
+        {
+        }
+
+        IRKernel::IRKernel(): IRKernel(NULL)
+        {
+        }
+
+        IRKernel::IRKernel(IRArena *arena)
+        {
+            nLength     = 0;
+            nLatency    = 0;
+            nDelay      = 0;
+            nOffset     = 0;
+            nMaxRank    = 0;
+            nHead       = 0;
+            vHead       = NULL;
+            nLevels     = 0;
+            nSize       = 0;
+            nReady      = 0;
+            nRefs       = 1;
+            pRegistry   = NULL;
+            pArena      = arena;
+            pData       = NULL;
+            pStorage    = NULL;
+
+            for (size_t i=0; i<LEVELS_MAX; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                l->nRank        = 0;
+                l->nBlock       = 0;
+                l->nFirst       = 0;
+                l->nParts       = 0;
+                l->nActive      = 0;
+                l->vParts       = NULL;
+                l->vActive      = NULL;
+            }
+        }
+
+        IRKernel::~IRKernel()
+        {
+            destroy();
+        }
+
+        void IRKernel::destroy()
+        {
+            // The attached data is owned by the storage
+            if (pStorage != NULL)
+            {
+                delete pStorage;
+                pStorage    = NULL;
+            }
+            else
+                IRArena::release(pArena, pData);
+            pData       = NULL;
+
+            nLength     = 0;
+            nLatency    = 0;
+            nDelay      = 0;
+            nOffset     = 0;
+            nMaxRank    = 0;
+            nHead       = 0;
+            vHead       = NULL;
+            nLevels     = 0;
+            nSize       = 0;
+            nReady      = 0;
+        }
+
+        IRKernel *IRKernel::acquire()
+        {
+            atomic_add(&nRefs, uatomic_t(1));
+            return this;
+        }
+
+        void IRKernel::release(IRKernel *k)
+        {
+            if (k == NULL)
+                return;
+
+            // The registry removes the published kernel under its lock, so no one can acquire it after the last release
+            if (k->pRegistry != NULL)
+            {
+                k->pRegistry->release_kernel(k);
+                return;
+            }
+
+            if (atomic_add(&k->nRefs, uatomic_t(-1)) <= 1)
+                delete k;
+        }
+
+        size_t IRKernel::silence(const float *ir, size_t length)
+        {
+            if (ir == NULL)
+                return 0;
+            const float thresh  = dsp::h_sqr_sum(ir, length) * SILENCE_LEVEL;
+            if (thresh <= 0.0f)
+                return 0;
+
+            float energy        = 0.0f;
+            for (size_t i=0; i<length; ++i)
+            {
+                energy             += ir[i] * ir[i];
+                if (energy > thresh)
+                    return i;
+            }
+
+            return length;
+        }
+
+        bool IRKernel::init(const float *ir, size_t length, size_t rank, size_t latency)
+        {
+            return init(ir, length, length, rank, latency);
+        }
+
+        bool IRKernel::init(const float *ir, size_t length, size_t span, size_t rank, size_t latency)
+        {
+            return init(ir, length, span, 0, rank, latency);
+        }
+
+        bool IRKernel::init(const float *ir, size_t length, size_t span, size_t silence, size_t rank, size_t latency)
+        {
+            return init(ir, length, span, silence, rank, latency, SIZE_MAX);
+        }
+
+        bool IRKernel::init(const float *ir, size_t length, size_t span, size_t silence, size_t rank, size_t latency, size_t immediate)
+        {
+            destroy();
+
+            // Compute the maximum block size and the allowed latency
+            rank                = lsp_limit(rank, HEAD_RANK + 1, MAX_RANK);
+            const size_t bmax   = size_t(1) << (rank - 1);
+            if (latency > 0)
+                latency             = size_t(1) << block_rank(lsp_limit(latency, HEAD_SIZE, bmax));
+            if (ir == NULL)
+                length              = 0;
+            const size_t ir_len = length;
+            span                = lsp_max(span, length);
+
+            // The leading silence and the latency are replaced by the offset of the first
+            // partition, the remainder is applied as a pure delay of the input. The silence
+            // which is too short to remove the direct head is convolved as usual.
+            silence             = lsp_min(silence, length);
+            size_t first_offset = 0;
+            size_t delay        = 0;
+            if ((latency + silence) >= HEAD_SIZE)
+            {
+                first_offset        = size_t(1) << block_rank(lsp_min(latency + silence, bmax));
+                delay               = latency + silence - first_offset;
+            }
+            else
+                silence             = 0;
+            if (ir != NULL)
+                ir                 += silence;
+            length             -= silence;
+            span               -= silence;
+
+            // Compute the layout: the direct head and then levels with growing block size.
+            const size_t total  = first_offset + span;
+            size_t head         = (first_offset > 0) ? 0 : lsp_min(span, HEAD_SIZE);
+            size_t offset       = (first_offset > 0) ? first_offset : HEAD_SIZE;
+            size_t block        = offset;
+            size_t floats       = align_size(head * sizeof(float), DEFAULT_ALIGN) / sizeof(float);
+            size_t flags        = 0;
+            size_t levels       = 0;
+
+            while (offset < total)
+            {
+                if (levels >= LEVELS_MAX)
+                    return false;
+
+                // The level should end at the offset which is a multiple of the doubled block size
+                const size_t first  = offset / block;
+                const size_t left   = (total - offset + block - 1) / block;
+                size_t parts        = (block >= bmax) ? left : (first & 1) ? 3 : 2;
+                parts               = lsp_min(parts, left);
+
+                level_t *l          = &vLevels[levels++];
+                l->nRank            = block_rank(block) + 1;
+                l->nBlock           = block;
+                l->nFirst           = first;
+                l->nParts           = parts;
+                l->nActive          = 0;
+                l->vParts           = NULL;
+                l->vActive          = NULL;
+
+                floats             += parts * block * 4;
+                flags              += parts;
+                offset             += parts * block;
+                if (block < bmax)
+                    block             <<= 1;
+            }
+
+            // Allocate memory
+            const size_t szof_floats    = align_size(lsp_max(floats, size_t(1)) * sizeof(float), DEFAULT_ALIGN);
+            const size_t szof_flags     = align_size(flags, DEFAULT_ALIGN);
+            uint8_t *data       = IRArena::acquire(pArena, szof_floats + szof_flags);
+            if (data == NULL)
+                return false;
+            uint8_t *ptr        = data;
+            uint8_t *fptr       = &ptr[szof_floats];
+            lsp_finally { IRArena::release(pArena, data); };
+
+            // Store the direct head
+            vHead               = advance_ptr_bytes<float>(ptr, align_size(head * sizeof(float), DEFAULT_ALIGN));
+            if (head > 0)
+            {
+                const size_t count  = lsp_min(head, length);
+                if (count > 0)
+                    dsp::copy(vHead, ir, count);
+                dsp::fill_zero(&vHead[count], head - count);
+            }
+
+            // Find partitions with negligible energy, they are skipped. The time-domain data of
+            // active partitions is staged in their own slots, so partitions are transformed in place
+            const float thresh  = (length > 0) ? dsp::h_sqr_sum(ir, length) * SILENCE_LEVEL : 0.0f;
+            size_t ready        = 0;
+            for (size_t i=0; i<levels; ++i)
+            {
+                level_t *l          = &vLevels[i];
+                const size_t b      = l->nBlock;
+                l->vParts           = advance_ptr_bytes<float>(ptr, l->nParts * b * 4 * sizeof(float));
+                l->vActive          = advance_ptr_bytes<uint8_t>(fptr, l->nParts);
+
+                for (size_t j=0; j<l->nParts; ++j)
+                {
+                    const size_t src    = (l->nFirst + j) * b - first_offset;
+                    const size_t count  = (src < length) ? lsp_min(b, length - src) : 0;
+                    const bool active   = (count > 0) && (dsp::h_sqr_sum(&ir[src], count) > thresh);
+                    l->vActive[j]       = (active) ? 1 : 0;
+                    if (!active)
+                        continue;
+
+                    float *dst          = &l->vParts[j * b * 4];
+                    dsp::copy(dst, &ir[src], count);
+                    dsp::fill_zero(&dst[count], b - count);
+                    ++l->nActive;
+                }
+
+                if ((ready == i) && (l->nFirst * b - first_offset < immediate))
+                    ++ready;
+            }
+
+            // Compute spectra of partitions of immediate levels
+            if (ready > 0)
+            {
+                float *tmp          = reinterpret_cast<float *>(IRArena::acquire(pArena, vLevels[ready - 1].nBlock * 2 * sizeof(float)));
+                if (tmp == NULL)
+                    return false;
+                lsp_finally { IRArena::release(pArena, reinterpret_cast<uint8_t *>(tmp)); };
+
+                for (size_t i=0; i<ready; ++i)
+                    transform(&vLevels[i], tmp);
+            }
+
+            // Commit the state
+            nLength             = ir_len;
+            nLatency            = latency;
+            nDelay              = delay;
+            nOffset             = first_offset;
+            nMaxRank            = (levels > 0) ? vLevels[levels - 1].nRank : 0;
+            nHead               = head;
+            nLevels             = levels;
+            nSize               = szof_floats + szof_flags;
+            nReady              = ready;
+            lsp::swap(pData, data);
+
+            lsp_trace("Initialized kernel: length=%d, latency=%d, delay=%d, offset=%d, head=%d, levels=%d",
+                int(nLength), int(nLatency), int(nDelay), int(nOffset), int(nHead), int(nLevels));
+
+            return true;
+        }
+
+        IRKernel::Transformer::Transformer(level_t *l)
+        {
+            pLevel      = l;
+        }
+
+        IRKernel::Transformer::~Transformer()
+        {
+        }
+
+        void IRKernel::Transformer::execute(size_t index, float *tmp)
+        {
+            transform(pLevel, index, tmp);
+        }
+
+        void IRKernel::transform(level_t *l, float *tmp)
+        {
+            for (size_t j=0; j<l->nParts; ++j)
+                transform(l, j, tmp);
+        }
+
+        void IRKernel::transform(level_t *l, size_t part, float *tmp)
+        {
+            if (!l->vActive[part])
+                return;
+
+            // The slot keeps the time-domain data of the partition in the first block
+            const size_t b      = l->nBlock;
+            float *dst          = &l->vParts[part * b * 4];
+
+            dsp::copy(tmp, dst, b);
+            dsp::fill_zero(&tmp[b], b);
+            dsp::pcomplex_r2c(dst, tmp, b * 2);
+            dsp::packed_direct_fft(dst, dst, l->nRank);
+        }
+
+        size_t IRKernel::ready() const
+        {
+            return atomic_load(const_cast<uatomic_t *>(&nReady));
+        }
+
+        bool IRKernel::prepare(IRPool *pool)
+        {
+            // The shared kernel can be prepared by threads of several instances
+            sPrepare.lock();
+            lsp_finally { sPrepare.unlock(); };
+
+            const size_t index  = nReady;
+            if (index >= nLevels)
+                return true;
+
+            level_t *l          = &vLevels[index];
+            float *tmp          = reinterpret_cast<float *>(IRArena::acquire(pArena, l->nBlock * 2 * sizeof(float)));
+            if (tmp == NULL)
+                return false;
+            lsp_finally { IRArena::release(pArena, reinterpret_cast<uint8_t *>(tmp)); };
+
+            // The level is applied by the convolver only after all partitions have been transformed
+            if (pool != NULL)
+            {
+                Transformer batch(l);
+                pool->run(&batch, l->nParts, tmp);
+            }
+            else
+                transform(l, tmp);
+            atomic_store(&nReady, uatomic_t(index + 1));
+
+            return true;
+        }
+
+        const void *IRKernel::export_image(image_t *image) const
+        {
+            if ((pData == NULL) || (!prepared()))
+                return NULL;
+
+            memset(image, 0, sizeof(image_t));
+            image->nLength      = nLength;
+            image->nLatency     = nLatency;
+            image->nDelay       = nDelay;
+            image->nOffset      = nOffset;
+            image->nHead        = nHead;
+            image->nLevels      = nLevels;
+            image->nSize        = nSize;
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                const level_t *l    = &vLevels[i];
+                image_level_t *il   = &image->vLevels[i];
+                il->nRank           = l->nRank;
+                il->nFirst          = l->nFirst;
+                il->nParts          = l->nParts;
+                il->nActive         = l->nActive;
+            }
+
+            return pData;
+        }
+
+        bool IRKernel::attach(const image_t *image, const void *data, size_t bytes, Storage *storage)
+        {
+            // Validate the layout, the image may come from the corrupted file
+            if ((data == NULL) || ((uintptr_t(data) % DEFAULT_ALIGN) != 0))
+                return false;
+            if ((image->nLevels > LEVELS_MAX) || (image->nHead > HEAD_SIZE) || (image->nSize > bytes))
+                return false;
+
+            size_t floats       = align_size(image->nHead * sizeof(float), DEFAULT_ALIGN) / sizeof(float);
+            size_t flags        = 0;
+            for (size_t i=0; i<image->nLevels; ++i)
+            {
+                const image_level_t *il = &image->vLevels[i];
+                if ((il->nRank <= HEAD_RANK) || (il->nRank > MAX_RANK) || (il->nParts <= 0) || (il->nActive > il->nParts))
+                    return false;
+                floats             += il->nParts * (size_t(1) << (il->nRank - 1)) * 4;
+                flags              += il->nParts;
+            }
+            const size_t szof_floats    = align_size(lsp_max(floats, size_t(1)) * sizeof(float), DEFAULT_ALIGN);
+            const size_t szof_flags     = align_size(flags, DEFAULT_ALIGN);
+            if (szof_floats + szof_flags != image->nSize)
+                return false;
+
+            // Bind pointers to the data block
+            uint8_t *ptr        = const_cast<uint8_t *>(static_cast<const uint8_t *>(data));
+            uint8_t *fptr       = &ptr[szof_floats];
+            level_t levels[LEVELS_MAX];
+            const float *head   = advance_ptr_bytes<float>(ptr, align_size(image->nHead * sizeof(float), DEFAULT_ALIGN));
+            for (size_t i=0; i<image->nLevels; ++i)
+            {
+                const image_level_t *il = &image->vLevels[i];
+                level_t *l          = &levels[i];
+                l->nRank            = il->nRank;
+                l->nBlock           = size_t(1) << (il->nRank - 1);
+                l->nFirst           = il->nFirst;
+                l->nParts           = il->nParts;
+                l->nActive          = il->nActive;
+                l->vParts           = advance_ptr_bytes<float>(ptr, l->nParts * l->nBlock * 4 * sizeof(float));
+                l->vActive          = advance_ptr_bytes<uint8_t>(fptr, l->nParts);
+
+                size_t active       = 0;
+                for (size_t j=0; j<l->nParts; ++j)
+                    active             += (l->vActive[j]) ? 1 : 0;
+                if (active != l->nActive)
+                    return false;
+            }
+
+            // Commit the state, all levels are ready
+            destroy();
+            for (size_t i=0; i<image->nLevels; ++i)
+                vLevels[i]          = levels[i];
+            nLength             = image->nLength;
+            nLatency            = image->nLatency;
+            nDelay              = image->nDelay;
+            nOffset             = image->nOffset;
+            nMaxRank            = (image->nLevels > 0) ? levels[image->nLevels - 1].nRank : 0;
+            nHead               = image->nHead;
+            vHead               = const_cast<float *>(head);
+            nLevels             = image->nLevels;
+            nSize               = image->nSize;
+            nReady              = nLevels;
+            pData               = const_cast<uint8_t *>(static_cast<const uint8_t *>(data));
+            pStorage            = storage;
+
+            return true;
+        }
+
+        bool IRKernel::compatible(const IRKernel *k) const
+        {
+            if ((k->nLatency != nLatency) ||
+                (k->nDelay != nDelay) ||
+                (k->nOffset != nOffset) ||
+                (k->nHead != nHead) ||
+                (k->nLevels != nLevels))
+                return false;
+
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                const level_t *a    = &vLevels[i];
+                const level_t *b    = &k->vLevels[i];
+                if ((a->nBlock != b->nBlock) ||
+                    (a->nFirst != b->nFirst) ||
+                    (a->nParts != b->nParts))
+                    return false;
+            }
+
+            return true;
+        }
+
+        void IRKernel::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nLength", nLength);
+            v->write("nLatency", nLatency);
+            v->write("nDelay", nDelay);
+            v->write("nOffset", nOffset);
+            v->write("nMaxRank", nMaxRank);
+            v->write("nHead", nHead);
+            v->write("vHead", vHead);
+            v->write("nLevels", nLevels);
+            v->begin_array("vLevels", vLevels, nLevels);
+            {
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    const level_t *l = &vLevels[i];
+                    v->begin_object(l, sizeof(level_t));
+                    {
+                        v->write("nRank", l->nRank);
+                        v->write("nBlock", l->nBlock);
+                        v->write("nFirst", l->nFirst);
+                        v->write("nParts", l->nParts);
+                        v->write("nActive", l->nActive);
+                        v->write("vParts", l->vParts);
+                        v->write("vActive", l->vActive);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("nSize", nSize);
+            v->write("nReady", nReady);
+            v->write("nRefs", nRefs);
+            v->write("pRegistry", pRegistry);
+            v->write("pArena", pArena);
+            v->write("pData", pData);
+            v->write("pStorage", pStorage);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
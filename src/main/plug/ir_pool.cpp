@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_pool.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t IDLE_WAIT_MS    = 50;
+
+        IRBatch::IRBatch()
+        {
+            pNext       = NULL;
+            nCount      = 0;
+            nNext       = 0;
+            nRefs       = 0;
+        }
+
+        IRBatch::~IRBatch()
+        {
+        }
+
+        void IRBatch::perform(float *tmp)
+        {
+            while (true)
+            {
+                const size_t index  = atomic_add(&nNext, uatomic_t(1));
+                if (index >= nCount)
+                    break;
+
+                execute(index, tmp);
+            }
+        }
+
+        void IRBatch::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pNext", pNext);
+            v->write("nCount", nCount);
+            v->write("nNext", nNext);
+            v->write("nRefs", nRefs);
+            v->write_object("sDone", &sDone);
+        }
+
+        //---------------------------------------------------------------------
+        IRPool::Worker::Worker(IRPool *pool)
+        {
+            pPool       = pool;
+            vScratch    = NULL;
+            pData       = NULL;
+        }
+
+        IRPool::Worker::~Worker()
+        {
+            free_aligned(pData);
+            vScratch    = NULL;
+            pPool       = NULL;
+        }
+
+        bool IRPool::Worker::init()
+        {
+            vScratch    = alloc_aligned<float>(pData, SCRATCH_SIZE, DEFAULT_ALIGN);
+            return vScratch != NULL;
+        }
+
+        status_t IRPool::Worker::run()
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            while (!is_cancelled())
+            {
+                // Sleep until the batch is published, the timeout allows to check for cancellation
+                IRBatch *batch  = pPool->acquire();
+                if (batch == NULL)
+                {
+                    pPool->sSignal.wait(IDLE_WAIT_MS);
+                    continue;
+                }
+
+                // The caller may destroy the batch after the signal, it is the last access to it
+                batch->perform(vScratch);
+                batch->sDone.post();
+            }
+
+            return STATUS_OK;
+        }
+
+        //---------------------------------------------------------------------
+        IRPool::IRPool()
+        {
+            pBatches    = NULL;
+            for (size_t i=0; i<THREADS_MAX; ++i)
+                vWorkers[i] = NULL;
+            nWorkers    = 0;
+            nRefs       = 0;
+        }
+
+        IRPool::~IRPool()
+        {
+            // All instances should unbind before the pool gets destroyed
+            if (nRefs > 0)
+                lsp_warn("Thread pool is still bound by %d instances", int(nRefs));
+            shutdown(vWorkers, nWorkers);
+            nWorkers    = 0;
+        }
+
+        IRPool *IRPool::instance()
+        {
+            static IRPool pool;
+            return &pool;
+        }
+
+        void IRPool::bind()
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            if ((nRefs++) > 0)
+                return;
+
+            // One core is left for the real-time thread, the caller of run() works as the pool thread too
+            const size_t cores  = ipc::Thread::system_cores();
+            const size_t count  = lsp_min((cores > 2) ? cores - 2 : 0, THREADS_MAX);
+            for (size_t i=0; i<count; ++i)
+            {
+                Worker *w           = new Worker(this);
+                if (w == NULL)
+                    break;
+                if ((!w->init()) || (w->start() != STATUS_OK))
+                {
+                    delete w;
+                    break;
+                }
+                vWorkers[nWorkers++]    = w;
+            }
+
+            lsp_trace("Started %d pool threads", int(nWorkers));
+        }
+
+        void IRPool::unbind()
+        {
+            // Threads are stopped outside of the lock since they take it to acquire batches
+            Worker *list[THREADS_MAX];
+            size_t count        = 0;
+
+            sLock.lock();
+            if ((nRefs > 0) && ((--nRefs) <= 0))
+            {
+                for (size_t i=0; i<nWorkers; ++i)
+                {
+                    list[count++]       = vWorkers[i];
+                    vWorkers[i]         = NULL;
+                }
+                nWorkers            = 0;
+            }
+            sLock.unlock();
+
+            shutdown(list, count);
+        }
+
+        void IRPool::shutdown(Worker **list, size_t count)
+        {
+            for (size_t i=0; i<count; ++i)
+                list[i]->cancel();
+            if (count > 0)
+                sSignal.post(count);
+
+            for (size_t i=0; i<count; ++i)
+            {
+                Worker *w           = list[i];
+                w->join();
+                delete w;
+                list[i]             = NULL;
+            }
+        }
+
+        IRBatch *IRPool::acquire()
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            // Take the first batch with items left, the reference keeps it alive until the thread leaves it
+            for (IRBatch *b = pBatches; b != NULL; b = b->pNext)
+            {
+                if (atomic_load(&b->nNext) >= b->nCount)
+                    continue;
+                ++b->nRefs;
+                return b;
+            }
+
+            return NULL;
+        }
+
+        void IRPool::run(IRBatch *batch, size_t count, float *tmp)
+        {
+            batch->pNext        = NULL;
+            batch->nCount       = count;
+            batch->nNext        = 0;
+            batch->nRefs        = 0;
+
+            // Publish the batch to the pool threads if there are more items than the caller can take at once
+            size_t wakeups      = 0;
+            if (count > 1)
+            {
+                sLock.lock();
+                wakeups             = lsp_min(count - 1, nWorkers);
+                if (wakeups > 0)
+                {
+                    batch->pNext        = pBatches;
+                    pBatches            = batch;
+                }
+                sLock.unlock();
+            }
+            if (wakeups > 0)
+                sSignal.post(wakeups);
+
+            batch->perform(tmp);
+            if (wakeups <= 0)
+                return;
+
+            // Remove the batch from the list, no more threads can take it
+            sLock.lock();
+            for (IRBatch **pb = &pBatches; *pb != NULL; pb = &(*pb)->pNext)
+            {
+                if (*pb != batch)
+                    continue;
+                *pb                 = batch->pNext;
+                break;
+            }
+            const size_t refs   = batch->nRefs;
+            sLock.unlock();
+
+            // Sleep until the pool threads complete items they have taken
+            for (size_t i=0; i<refs; )
+            {
+                if (batch->sDone.wait(IDLE_WAIT_MS))
+                    ++i;
+            }
+        }
+
+        size_t IRPool::threads() const
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+            return nWorkers;
+        }
+
+        void IRPool::dump(dspu::IStateDumper *v) const
+        {
+            v->write_object("sSignal", &sSignal);
+            v->write("pBatches", pBatches);
+            v->writev("vWorkers", vWorkers, THREADS_MAX);
+            v->write("nWorkers", nWorkers);
+            v->write("nRefs", nRefs);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_registry.h>
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        IRRegistry::IRRegistry()
+        {
+            pEntries    = NULL;
+            pKernels    = NULL;
+            nBytes      = 0;
+        }
+
+        IRRegistry::~IRRegistry()
+        {
+            // All instances should release their data before the registry gets destroyed
+            while (pEntries != NULL)
+            {
+                entry_t *next   = pEntries->pNext;
+                lsp_warn("Leaked shared sample %p (%s), references=%d", pEntries->pSample, pEntries->sPath, int(pEntries->nRefs));
+                destroy_entry(pEntries);
+                pEntries        = next;
+            }
+            while (pKernels != NULL)
+            {
+                kernel_t *next  = pKernels->pNext;
+                lsp_warn("Leaked shared kernel %p, references=%d", pKernels->pKernel, int(pKernels->pKernel->nRefs));
+                delete pKernels->pKernel;
+                delete pKernels;
+                pKernels        = next;
+            }
+            nBytes      = 0;
+        }
+
+        IRRegistry *IRRegistry::instance()
+        {
+            static IRRegistry registry;
+            return &registry;
+        }
+
+        void IRRegistry::destroy_sample(dspu::Sample *s)
+        {
+            s->destroy();
+            delete s;
+        }
+
+        void IRRegistry::destroy_entry(entry_t *e)
+        {
+            if (e->pSample != NULL)
+            {
+                destroy_sample(e->pSample);
+                e->pSample      = NULL;
+            }
+            if (e->sPath != NULL)
+            {
+                free(e->sPath);
+                e->sPath        = NULL;
+            }
+            delete e;
+        }
+
+        IRRegistry::entry_t *IRRegistry::find(const char *path, uint64_t hash, size_t sample_rate)
+        {
+            for (entry_t *e = pEntries; e != NULL; e = e->pNext)
+            {
+                if ((e->nHash == hash) &&
+                    (e->nSampleRate == sample_rate) &&
+                    (strcmp(e->sPath, path) == 0))
+                    return e;
+            }
+            return NULL;
+        }
+
+        dspu::Sample *IRRegistry::acquire(const char *path, uint64_t hash, size_t sample_rate)
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            entry_t *e = find(path, hash, sample_rate);
+            if (e == NULL)
+                return NULL;
+
+            ++e->nRefs;
+            return e->pSample;
+        }
+
+        dspu::Sample *IRRegistry::publish(const char *path, uint64_t hash, size_t sample_rate, dspu::Sample *s)
+        {
+            if (s == NULL)
+                return NULL;
+
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            // Another instance could publish the same data while this one has been preparing it
+            entry_t *e = find(path, hash, sample_rate);
+            if (e != NULL)
+            {
+                destroy_sample(s);
+
+                ++e->nRefs;
+                return e->pSample;
+            }
+
+            // Create new entry, the sample is destroyed on error since the caller has passed the ownership
+            e                   = new entry_t;
+            if (e == NULL)
+            {
+                destroy_sample(s);
+                return NULL;
+            }
+            e->sPath            = strdup(path);
+            if (e->sPath == NULL)
+            {
+                delete e;
+                destroy_sample(s);
+                return NULL;
+            }
+
+            e->nHash            = hash;
+            e->nSampleRate      = sample_rate;
+            e->nRefs            = 1;
+            e->nBytes           = s->channels() * s->samples() * sizeof(float);
+            e->pSample          = s;
+            e->pNext            = pEntries;
+            pEntries            = e;
+            atomic_add(&nBytes, uatomic_t(e->nBytes));
+
+            lsp_trace("Published shared sample %p (%s), resident=%d bytes", s, path, int(nBytes));
+
+            return s;
+        }
+
+        void IRRegistry::release(dspu::Sample *s)
+        {
+            if (s == NULL)
+                return;
+
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            for (entry_t **pe = &pEntries; *pe != NULL; pe = &(*pe)->pNext)
+            {
+                entry_t *e = *pe;
+                if (e->pSample != s)
+                    continue;
+
+                // Destroy entry if there are no more references
+                if ((--e->nRefs) <= 0)
+                {
+                    *pe                 = e->pNext;
+                    atomic_add(&nBytes, -uatomic_t(e->nBytes));
+                    lsp_trace("Destroyed shared sample %p (%s), resident=%d bytes", s, e->sPath, int(nBytes));
+                    destroy_entry(e);
+                }
+                return;
+            }
+
+            lsp_warn("Sample %p is not registered", s);
+        }
+
+        IRRegistry::kernel_t *IRRegistry::find_kernel(const kernel_key_t *key)
+        {
+            for (kernel_t *e = pKernels; e != NULL; e = e->pNext)
+            {
+                if ((e->sKey.nHash == key->nHash) &&
+                    (e->sKey.nSampleRate == key->nSampleRate) &&
+                    (e->sKey.nRank == key->nRank) &&
+                    (e->sKey.nLatency == key->nLatency))
+                    return e;
+            }
+            return NULL;
+        }
+
+        IRKernel *IRRegistry::acquire_kernel(const kernel_key_t *key)
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            kernel_t *e = find_kernel(key);
+            return (e != NULL) ? e->pKernel->acquire() : NULL;
+        }
+
+        IRKernel *IRRegistry::publish_kernel(const kernel_key_t *key, IRKernel *k)
+        {
+            // Memory of the arena can not outlive the instance
+            if ((k == NULL) || (k->pArena != NULL) || (k->pRegistry != NULL))
+                return k;
+
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            // Another instance could publish the same kernel while this one has been building it
+            kernel_t *e = find_kernel(key);
+            if (e != NULL)
+            {
+                delete k;
+                return e->pKernel->acquire();
+            }
+
+            // The kernel stays private to the caller if there is no memory for the entry
+            e                   = new kernel_t;
+            if (e == NULL)
+                return k;
+
+            e->sKey             = *key;
+            e->nBytes           = k->size();
+            e->pKernel          = k;
+            e->pNext            = pKernels;
+            pKernels            = e;
+            atomic_add(&nBytes, uatomic_t(e->nBytes));
+            k->pRegistry        = this;
+
+            lsp_trace("Published shared kernel %p, resident=%d bytes", k, int(nBytes));
+
+            return k;
+        }
+
+        void IRRegistry::release_kernel(IRKernel *k)
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            if (atomic_add(&k->nRefs, uatomic_t(-1)) > 1)
+                return;
+
+            // Destroy entry if there are no more references
+            for (kernel_t **pe = &pKernels; *pe != NULL; pe = &(*pe)->pNext)
+            {
+                kernel_t *e = *pe;
+                if (e->pKernel != k)
+                    continue;
+
+                *pe                 = e->pNext;
+                atomic_add(&nBytes, -uatomic_t(e->nBytes));
+                delete e;
+                break;
+            }
+
+            lsp_trace("Destroyed shared kernel %p, resident=%d bytes", k, int(nBytes));
+            delete k;
+        }
+
+        size_t IRRegistry::resident_bytes() const
+        {
+            return atomic_load(&nBytes);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
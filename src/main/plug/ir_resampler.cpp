@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_resampler.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t TAPS_PER_FACTOR     = 32;       // Number of taps of the filter per unit of the factor
+        static constexpr size_t TAPS_MAX            = TAPS_PER_FACTOR * IRResampler::FACTOR_MAX + 1;
+        static constexpr double CUTOFF              = 0.8;      // Cutoff frequency relative to the Nyquist frequency of the low sample rate
+
+        static void design_filter(float *dst, size_t factor)
+        {
+            // Blackman-windowed sinc normalized to the unit gain at DC
+            const size_t taps   = IRResampler::taps(factor);
+            const size_t center = (taps - 1) / 2;
+            const double fc     = CUTOFF * 0.5 / double(factor);
+            const double wk     = 2.0 * M_PI / double(taps - 1);
+            double sum          = 0.0;
+
+            for (size_t i=0; i<taps; ++i)
+            {
+                const double x      = double(i) - double(center);
+                const double s      = (i == center) ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x);
+                const double w      = 0.42 - 0.5 * cos(wk * i) + 0.08 * cos(2.0 * wk * i);
+                dst[i]              = float(s * w);
+                sum                += dst[i];
+            }
+
+            dsp::mul_k2(dst, float(1.0 / sum), taps);
+        }
+
+        IRResampler::IRResampler()
+        {
+            nFactor     = 0;
+            nTaps       = 0;
+            nPoly       = 0;
+            nPhase      = 0;
+            vFilter     = NULL;
+            vPoly       = NULL;
+            vBuffer     = NULL;
+            pData       = NULL;
+        }
+
+        IRResampler::~IRResampler()
+        {
+            destroy();
+        }
+
+        void IRResampler::destroy()
+        {
+            free_aligned(pData);
+
+            nFactor     = 0;
+            nTaps       = 0;
+            nPoly       = 0;
+            nPhase      = 0;
+            vFilter     = NULL;
+            vPoly       = NULL;
+            vBuffer     = NULL;
+        }
+
+        size_t IRResampler::taps(size_t factor)
+        {
+            return TAPS_PER_FACTOR * factor + 1;
+        }
+
+        size_t IRResampler::delay(size_t factor)
+        {
+            return (TAPS_PER_FACTOR * factor) >> 1;
+        }
+
+        size_t IRResampler::decimated_length(size_t length, size_t factor)
+        {
+            return (length + delay(factor) + factor - 1) / factor;
+        }
+
+        bool IRResampler::init(size_t factor)
+        {
+            if ((factor < 2) || (factor > FACTOR_MAX))
+                return false;
+
+            const size_t taps       = IRResampler::taps(factor);
+            const size_t poly       = (taps + factor - 1) / factor;
+            const size_t buf_size   = lsp_max(taps - 1 + BLOCK_SIZE, poly + BLOCK_SIZE / factor + 1);
+            const size_t szof_filter= align_size(taps * sizeof(float), DEFAULT_ALIGN);
+            const size_t szof_poly  = align_size(poly * factor * sizeof(float), DEFAULT_ALIGN);
+            const size_t szof_buf   = align_size(buf_size * sizeof(float), DEFAULT_ALIGN);
+
+            uint8_t *data           = NULL;
+            uint8_t *ptr            = alloc_aligned<uint8_t>(data, szof_filter + szof_poly + szof_buf, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return false;
+
+            destroy();
+
+            vFilter                 = advance_ptr_bytes<float>(ptr, szof_filter);
+            vPoly                   = advance_ptr_bytes<float>(ptr, szof_poly);
+            vBuffer                 = advance_ptr_bytes<float>(ptr, szof_buf);
+            pData                   = data;
+
+            nFactor                 = factor;
+            nTaps                   = taps;
+            nPoly                   = poly;
+            nPhase                  = 0;
+
+            // Prepare the filter and reversed polyphase components of the interpolation filter,
+            // the interpolation filter has the gain equal to the factor to compensate zero stuffing
+            design_filter(vFilter, factor);
+            for (size_t r=0; r<factor; ++r)
+            {
+                float *dst              = &vPoly[r * poly];
+                for (size_t q=0; q<poly; ++q)
+                {
+                    const size_t idx        = r + q * factor;
+                    dst[poly - 1 - q]       = (idx < taps) ? vFilter[idx] * factor : 0.0f;
+                }
+            }
+            dsp::fill_zero(vBuffer, buf_size);
+
+            return true;
+        }
+
+        void IRResampler::clear()
+        {
+            if (vBuffer == NULL)
+                return;
+            dsp::fill_zero(vBuffer, lsp_max(nTaps - 1 + BLOCK_SIZE, nPoly + BLOCK_SIZE / nFactor + 1));
+        }
+
+        size_t IRResampler::downsample(float *dst, const float *src, size_t count)
+        {
+            // Compute the filter only for samples which are kept
+            const size_t hist   = nTaps - 1;
+            dsp::copy(&vBuffer[hist], src, count);
+
+            size_t n            = 0;
+            for (size_t i=(nFactor - nPhase) % nFactor; i<count; i += nFactor)
+                dst[n++]            = dsp::h_dotp(&vBuffer[i], vFilter, nTaps);
+
+            nPhase              = (nPhase + count) % nFactor;
+            dsp::move(vBuffer, &vBuffer[count], hist);
+
+            return n;
+        }
+
+        void IRResampler::upsample(float *dst, const float *src, size_t count)
+        {
+            // Number of samples of the low sample rate which correspond to the block
+            const size_t first  = (nFactor - nPhase) % nFactor;
+            const size_t n      = (first < count) ? (count - first + nFactor - 1) / nFactor : 0;
+            const size_t hist   = nPoly;
+            dsp::copy(&vBuffer[hist], src, n);
+
+            // Each sample of the high sample rate is computed by the polyphase component
+            // applied to the most recent samples of the low sample rate
+            size_t pos          = (nPhase == 0) ? hist : hist - 1;
+            size_t r            = nPhase;
+            for (size_t i=0; i<count; ++i)
+            {
+                dst[i]             += dsp::h_dotp(&vBuffer[pos + 1 - nPoly], &vPoly[r * nPoly], nPoly);
+                if ((++r) >= nFactor)
+                {
+                    r                   = 0;
+                    ++pos;
+                }
+            }
+
+            nPhase              = (nPhase + count) % nFactor;
+            dsp::move(vBuffer, &vBuffer[n], hist);
+        }
+
+        void IRResampler::decimate(float *dst, const float *src, size_t length, size_t factor)
+        {
+            float filter[TAPS_MAX];
+            design_filter(filter, factor);
+
+            // The filter is symmetric, so it can be applied as the dot product centered at the sample
+            const ssize_t taps      = IRResampler::taps(factor);
+            const ssize_t center    = delay(factor);
+            const size_t count      = decimated_length(length, factor);
+
+            for (size_t k=0; k<count; ++k)
+            {
+                const ssize_t start     = ssize_t(k * factor) - center;
+                const ssize_t j0        = lsp_max(-start, ssize_t(0));
+                const ssize_t j1        = lsp_min(taps, ssize_t(length) - start);
+                dst[k]                  = (j1 > j0) ? dsp::h_dotp(&src[start + j0], &filter[j0], j1 - j0) * factor : 0.0f;
+            }
+        }
+
+        void IRResampler::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nFactor", nFactor);
+            v->write("nTaps", nTaps);
+            v->write("nPoly", nPoly);
+            v->write("nPhase", nPhase);
+            v->write("vFilter", vFilter);
+            v->write("vPoly", vPoly);
+            v->write("vBuffer", vBuffer);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_signal.h>
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/finally.h>
+
+#if defined(PLATFORM_WINDOWS)
+    #include <windows.h>
+#elif defined(PLATFORM_MACOSX)
+    #include <dispatch/dispatch.h>
+#else
+    #include <errno.h>
+    #include <semaphore.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        IRSignal::IRSignal()
+        {
+            nCount      = 0;
+        }
+
+        IRSignal::~IRSignal()
+        {
+        }
+
+        void IRSignal::post(size_t count)
+        {
+            // Notify under the lock: the waiting thread can not return and destroy the object before
+            sCond.lock();
+            lsp_finally { sCond.unlock(); };
+            nCount     += count;
+            if (count > 1)
+                sCond.notify_all();
+            else
+                sCond.notify();
+        }
+
+        bool IRSignal::wait(size_t millis)
+        {
+            sCond.lock();
+            lsp_finally { sCond.unlock(); };
+
+            // Spurious wakeups are not retried, callers wait in the loop
+            if (nCount <= 0)
+                sCond.wait(millis);
+            if (nCount <= 0)
+                return false;
+
+            --nCount;
+            return true;
+        }
+
+        void IRSignal::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nCount", nCount);
+        }
+
+        //---------------------------------------------------------------------
+        IRSemaphore::IRSemaphore()
+        {
+            hHandle     = NULL;
+        }
+
+        IRSemaphore::~IRSemaphore()
+        {
+            destroy();
+        }
+
+        bool IRSemaphore::init()
+        {
+            if (hHandle != NULL)
+                return true;
+
+        #if defined(PLATFORM_WINDOWS)
+            hHandle     = CreateSemaphoreW(NULL, 0, LONG_MAX, NULL);
+        #elif defined(PLATFORM_MACOSX)
+            hHandle     = dispatch_semaphore_create(0);
+        #else
+            sem_t *sem  = static_cast<sem_t *>(malloc(sizeof(sem_t)));
+            if (sem == NULL)
+                return false;
+            if (sem_init(sem, 0, 0) != 0)
+            {
+                free(sem);
+                return false;
+            }
+            hHandle     = sem;
+        #endif /* PLATFORM_WINDOWS */
+
+            return hHandle != NULL;
+        }
+
+        void IRSemaphore::destroy()
+        {
+            if (hHandle == NULL)
+                return;
+
+        #if defined(PLATFORM_WINDOWS)
+            CloseHandle(hHandle);
+        #elif defined(PLATFORM_MACOSX)
+            dispatch_release(static_cast<dispatch_semaphore_t>(hHandle));
+        #else
+            sem_t *sem  = static_cast<sem_t *>(hHandle);
+            sem_destroy(sem);
+            free(sem);
+        #endif /* PLATFORM_WINDOWS */
+
+            hHandle     = NULL;
+        }
+
+        void IRSemaphore::post()
+        {
+        #if defined(PLATFORM_WINDOWS)
+            ReleaseSemaphore(hHandle, 1, NULL);
+        #elif defined(PLATFORM_MACOSX)
+            dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(hHandle));
+        #else
+            sem_post(static_cast<sem_t *>(hHandle));
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        void IRSemaphore::wait()
+        {
+        #if defined(PLATFORM_WINDOWS)
+            WaitForSingleObject(hHandle, INFINITE);
+        #elif defined(PLATFORM_MACOSX)
+            dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(hHandle), DISPATCH_TIME_FOREVER);
+        #else
+            sem_t *sem  = static_cast<sem_t *>(hHandle);
+            while ((sem_wait(sem) != 0) && (errno == EINTR))
+                continue;
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        void IRSemaphore::dump(dspu::IStateDumper *v) const
+        {
+            v->write("hHandle", hHandle);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
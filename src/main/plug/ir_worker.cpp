@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2025 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2025 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-impulse-responses
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-impulse-responses is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-impulse-responses is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-impulse-responses. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/ir_worker.h>
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t IDLE_SLEEP_MS   = 1;
+
+        //---------------------------------------------------------------------
+        IRJob::IRJob()
+        {
+            nState      = JS_IDLE;
+            nQueued     = 0;
+        }
+
+        IRJob::~IRJob()
+        {
+        }
+
+        bool IRJob::run()
+        {
+            if (!atomic_cas(&nState, uatomic_t(JS_PENDING), uatomic_t(JS_RUNNING)))
+                return false;
+
+            execute();
+            atomic_store(&nState, uatomic_t(JS_DONE));
+            return true;
+        }
+
+        IRJob::job_deadline_t IRJob::complete()
+        {
+            // Execute the job if the worker did not start it
+            if (run())
+                return JD_MISSED;
+
+            return (atomic_load(&nState) == JS_RUNNING) ? JD_BUSY : JD_DONE;
+        }
+
+        bool IRJob::cancel()
+        {
+            atomic_cas(&nState, uatomic_t(JS_PENDING), uatomic_t(JS_IDLE));
+            return atomic_load(&nState) != JS_RUNNING;
+        }
+
+        void IRJob::sync()
+        {
+            atomic_cas(&nState, uatomic_t(JS_PENDING), uatomic_t(JS_IDLE));
+
+            while ((atomic_load(&nQueued) > 0) || (atomic_load(&nState) == JS_RUNNING))
+                ipc::Thread::sleep(IDLE_SLEEP_MS);
+        }
+
+        void IRJob::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nState", nState);
+            v->write("nQueued", nQueued);
+        }
+
+        //---------------------------------------------------------------------
+        IRWorker::IRWorker()
+        {
+            for (size_t i=0; i<QUEUE_SIZE; ++i)
+                vQueue[i]   = NULL;
+            nHead       = 0;
+            nTail       = 0;
+            nSleep      = 0;
+            bActive     = false;
+        }
+
+        IRWorker::~IRWorker()
+        {
+            shutdown();
+        }
+
+        status_t IRWorker::launch()
+        {
+            if (bActive)
+                return STATUS_OK;
+
+            if (!sWakeup.init())
+                return STATUS_NO_MEM;
+
+            status_t res    = start();
+            bActive         = (res == STATUS_OK);
+            return res;
+        }
+
+        void IRWorker::shutdown()
+        {
+            if (!bActive)
+                return;
+
+            cancel();
+            sWakeup.post();
+            join();
+            sWakeup.destroy();
+            bActive     = false;
+
+            // Release jobs that have not been processed
+            for (IRJob *job = pop(); job != NULL; job = pop())
+                atomic_add(&job->nQueued, uatomic_t(-1));
+        }
+
+        bool IRWorker::submit(IRJob *job)
+        {
+            atomic_store(&job->nState, uatomic_t(IRJob::JS_PENDING));
+            if (!bActive)
+                return false;
+
+            // Check that the queue is not full
+            const uatomic_t tail    = nTail;
+            if ((tail - atomic_load(&nHead)) >= QUEUE_SIZE)
+                return false;
+
+            // Reference the job first to prevent it from being released before it is processed
+            atomic_add(&job->nQueued, uatomic_t(1));
+            vQueue[tail % QUEUE_SIZE]   = job;
+            atomic_store(&nTail, uatomic_t(tail + 1));
+
+            // The semaphore is posted without locks and only if the worker has announced to sleep
+            if (atomic_swap(&nSleep, uatomic_t(0)) != 0)
+                sWakeup.post();
+
+            return true;
+        }
+
+        IRJob *IRWorker::pop()
+        {
+            const uatomic_t head    = nHead;
+            if (head == atomic_load(&nTail))
+                return NULL;
+
+            IRJob *job              = vQueue[head % QUEUE_SIZE];
+            atomic_store(&nHead, uatomic_t(head + 1));
+            return job;
+        }
+
+        status_t IRWorker::run()
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            while (!is_cancelled())
+            {
+                IRJob *job      = pop();
+                if (job == NULL)
+                {
+                    // Announce the sleep before checking the queue again: the producer either sees
+                    // the flag and posts the semaphore, or the submitted job is seen here
+                    atomic_swap(&nSleep, uatomic_t(1));
+                    if ((nHead == atomic_load(&nTail)) && (!is_cancelled()))
+                        sWakeup.wait();
+                    atomic_swap(&nSleep, uatomic_t(0));
+                    continue;
+                }
+
+                // The job could be already executed by the real-time thread or cancelled
+                job->run();
+                atomic_add(&job->nQueued, uatomic_t(-1));
+            }
+
+            return STATUS_OK;
+        }
+
+        void IRWorker::dump(dspu::IStateDumper *v) const
+        {
+            v->writev("vQueue", vQueue, QUEUE_SIZE);
+            v->write("nHead", nHead);
+            v->write("nTail", nTail);
+            v->write("nSleep", nSleep);
+            v->write_object("sWakeup", &sWakeup);
+            v->write("bActive", bActive);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
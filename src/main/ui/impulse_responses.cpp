@@ -31,10 +31,11 @@ namespace lsp
         static const meta::plugin_t *plugin_uis[] =
         {
             &meta::impulse_responses_mono,
-            &meta::impulse_responses_stereo
+            &meta::impulse_responses_stereo,
+            &meta::impulse_responses_mono_stereo
         };
 
-        static ui::Factory factory(plugin_uis, 2);
+        static ui::Factory factory(plugin_uis, 3);
 
     } // namespace plugui
 } // namespace lsp